@@ -0,0 +1,49 @@
+#! /usr/bin/env python
+
+# Copyright 2020
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+# This script tests the particle merging.
+# The electrons do not deposit, so that the fields remain zero and the
+# momentum of each particle is constant. The particles of each momentum bin
+# of each cell are replaced by two particles at each step: the number of
+# particles decreases, while the total weight, momentum and energy must be
+# the same in the first and the last plotfiles.
+
+import sys
+import re
+import yt
+import numpy as np
+import scipy.constants as scc
+
+tolerance = 1.e-10
+
+last_fn = sys.argv[1]
+first_fn = re.sub("[0-9]+$", lambda m: "0"*len(m.group()), last_fn)
+
+def get_totals(fn):
+    ad = yt.load(fn).all_data()
+    w = ad['particle_weight'].to_ndarray()
+    ux = ad['particle_momentum_x'].to_ndarray()/(scc.m_e*scc.c)
+    uy = ad['particle_momentum_y'].to_ndarray()/(scc.m_e*scc.c)
+    uz = ad['particle_momentum_z'].to_ndarray()/(scc.m_e*scc.c)
+    gamma = np.sqrt(1. + ux**2 + uy**2 + uz**2)
+    return w.size, np.array([np.sum(w), np.sum(w*ux), np.sum(w*uy),
+                             np.sum(w*uz), np.sum(w*gamma)])
+
+np_first, totals_first = get_totals(first_fn)
+np_last, totals_last = get_totals(last_fn)
+
+print('number of particles: ', np_first, '->', np_last)
+assert(np_last < np_first)
+
+# The total momentum along y and z is small: the errors are relative to
+# the total energy, the largest of the totals
+error = np.abs(totals_last - totals_first)/totals_first[4]
+error[0] = np.abs(totals_last[0] - totals_first[0])/totals_first[0]
+print('relative errors of the total weight, momentum and energy: ', error)
+print('tolerance = ', tolerance)
+assert(np.all(error < tolerance))
@@ -770,8 +770,7 @@ void BackTransformedDiagnostic::Flush(const Geometry& /*geom*/)
 
 void
 BackTransformedDiagnostic::
-writeLabFrameData(const MultiFab* cell_centered_data,
-                  const MultiParticleContainer& mypc,
+writeLabFrameData(const MultiParticleContainer& mypc,
                   const Geometry& geom, const Real t_boost, const Real dt) {
 
     WARPX_PROFILE("BackTransformedDiagnostic::writeLabFrameData");
@@ -782,16 +781,14 @@ writeLabFrameData(const MultiFab* cell_centered_data,
     const Real zlo_boost = domain_z_boost.lo(m_boost_direction_);
     const Real zhi_boost = domain_z_boost.hi(m_boost_direction_);
 
-    const std::vector<std::string> species_names = mypc.GetSpeciesNames();
-    Real prev_t_lab = -dt;
-    std::unique_ptr<amrex::MultiFab> tmp_slice_ptr;
-    std::unique_ptr<amrex::MultiFab> slice;
-    amrex::Vector<WarpXParticleContainer::DiagnosticParticleData> tmp_particle_buffer;
-
-    // Loop over snapshots
-    for (int i = 0; i < m_LabFrameDiags_.size(); ++i) {
-        // Get updated z position of snapshot
-        const Real old_z_boost = m_LabFrameDiags_[i]->m_current_z_boost;
+    // Get updated z position of snapshots, and the planes of the
+    // boosted frame where the active ones are.
+    const int ndiags = m_LabFrameDiags_.size();
+    Vector<Real> old_z_boost(ndiags);
+    Vector<int> is_active(ndiags, 0);
+    Vector<Real> active_z_boost;
+    for (int i = 0; i < ndiags; ++i) {
+        old_z_boost[i] = m_LabFrameDiags_[i]->m_current_z_boost;
         m_LabFrameDiags_[i]->updateCurrentZPositions(t_boost,
                                               m_inv_gamma_boost_,
                                               m_inv_beta_boost_);
@@ -804,6 +801,27 @@ writeLabFrameData(const MultiFab* cell_centered_data,
              ( m_LabFrameDiags_[i]->m_current_z_lab < diag_zmin_lab) or
              ( m_LabFrameDiags_[i]->m_current_z_lab > diag_zmax_lab) ) continue;
 
+        is_active[i] = 1;
+        active_z_boost.push_back(m_LabFrameDiags_[i]->m_current_z_boost);
+    }
+
+    // The fields are only cell-centered around these planes
+    std::unique_ptr<MultiFab> cell_centered_data;
+    if (WarpX::do_back_transformed_fields && !active_z_boost.empty()) {
+        cell_centered_data = WarpX::GetInstance().GetCellCenteredSlabData(
+                                 m_boost_direction_, active_z_boost);
+    }
+
+    const std::vector<std::string> species_names = mypc.GetSpeciesNames();
+    Real prev_t_lab = -dt;
+    std::unique_ptr<amrex::MultiFab> tmp_slice_ptr;
+    std::unique_ptr<amrex::MultiFab> slice;
+    amrex::Vector<WarpXParticleContainer::DiagnosticParticleData> tmp_particle_buffer;
+
+    // Loop over snapshots
+    for (int i = 0; i < ndiags; ++i) {
+        if (!is_active[i]) continue;
+
         // Get z index of data_buffer_ (i.e. in the lab frame) where
         // simulation domain (t', [zmin',zmax']), back-transformed to lab
         // frame, intersects with snapshot.
@@ -860,9 +878,11 @@ writeLabFrameData(const MultiFab* cell_centered_data,
              // Make it a BoxArray slice_ba
              BoxArray slice_ba(slice_box);
              slice_ba.maxSize(m_max_box_size_);
+             // The memory of the slices of the previous steps is reused
              tmp_slice_ptr = std::unique_ptr<MultiFab>(new MultiFab(slice_ba,
                              m_LabFrameDiags_[i]->m_data_buffer_->DistributionMap(),
-                             ncomp, 0));
+                             ncomp, 0,
+                             MFInfo().SetArena(WarpX::GetInstance().ScratchPool().TileArena())));
 
              // slice is re-used if the t_lab of a diag is equal to
              // that of the previous diag.
@@ -887,13 +907,25 @@ writeLabFrameData(const MultiFab* cell_centered_data,
                }
                tmp_particle_buffer.resize(mypc.nSpeciesBackTransformedDiagnostics());
                mypc.GetLabFrameData(m_LabFrameDiags_[i]->m_file_name, i_lab,
-                                    m_boost_direction_, old_z_boost,
+                                    m_boost_direction_, old_z_boost[i],
                                     m_LabFrameDiags_[i]->m_current_z_boost,
                                     t_boost, m_LabFrameDiags_[i]->m_t_lab, dt,
                                     tmp_particle_buffer);
             }
-            m_LabFrameDiags_[i]->AddPartDataToParticleBuffer(tmp_particle_buffer,
-                               mypc.nSpeciesBackTransformedDiagnostics());
+            // The particles are moved to the buffer of the last active
+            // diag with this t_lab, and copied for the others.
+            bool is_reused = false;
+            for (int j = i+1; j < ndiags && !is_reused; ++j) {
+                is_reused = is_active[j] && m_LabFrameDiags_[j]->m_t_lab == m_LabFrameDiags_[i]->m_t_lab;
+            }
+            if (is_reused) {
+                auto particle_buffer = tmp_particle_buffer;
+                m_LabFrameDiags_[i]->AddPartDataToParticleBuffer(std::move(particle_buffer),
+                                   mypc.nSpeciesBackTransformedDiagnostics());
+            } else {
+                m_LabFrameDiags_[i]->AddPartDataToParticleBuffer(std::move(tmp_particle_buffer),
+                                   mypc.nSpeciesBackTransformedDiagnostics());
+            }
         }
 
         ++m_LabFrameDiags_[i]->m_buff_counter_;
@@ -1373,7 +1405,7 @@ AddDataToBuffer( MultiFab& tmp, int k_lab,
 void
 LabFrameSnapShot::
 AddPartDataToParticleBuffer(
-    Vector<WarpXParticleContainer::DiagnosticParticleData> tmp_particle_buffer,
+    Vector<WarpXParticleContainer::DiagnosticParticleData>&& tmp_particle_buffer,
     int nspeciesBoostedFrame) {
     for (int isp = 0; isp < nspeciesBoostedFrame; ++isp) {
         auto np = tmp_particle_buffer[isp].GetRealData(DiagIdx::w).size();
@@ -1383,6 +1415,11 @@ AddPartDataToParticleBuffer(
         // This is a growing array. Each time we add np elements
         // to the existing array which has size = init_size
         const int init_size = m_particles_buffer_[isp].GetRealData(DiagIdx::w).size();
+        if (init_size == 0) {
+            // the buffer is empty: take the particles without copying them
+            m_particles_buffer_[isp] = std::move(tmp_particle_buffer[isp]);
+            continue;
+        }
         const int total_size = init_size + np;
         m_particles_buffer_[isp].resize(total_size);
 
@@ -1435,7 +1472,7 @@ AddPartDataToParticleBuffer(
 void
 LabFrameSlice::
 AddPartDataToParticleBuffer(
-    Vector<WarpXParticleContainer::DiagnosticParticleData> tmp_particle_buffer,
+    Vector<WarpXParticleContainer::DiagnosticParticleData>&& tmp_particle_buffer,
     int nSpeciesBackTransformedDiagnostics) {
 
 
@@ -52,17 +52,35 @@ Diagnostics::ReadParameters ()
             std::remove(varnames.begin(), varnames.end(), "proc_number"),
             varnames.end());
     }
+    m_num_user_varnames = varnames.size();
 }
 
 void
 Diagnostics::InitData ()
 {
     Print()<<"Diagnostics::InitData\n";
+    InitializeFieldFunctors();
+    // Construct Flush class. So far, only Plotfile is implemented.
+    m_flush_format = new FlushFormatPlotfile;
+}
+
+void
+Diagnostics::InitializeFieldFunctors ()
+{
     auto & warpx = WarpX::GetInstance();
+    // When the grids change, the functors of the old fields are replaced
+    for (auto& lev_functors : all_field_functors) {
+        for (auto& functor : lev_functors) delete functor;
+    }
+    all_field_functors.clear();
+    m_rho_new.clear();
+    // and the names of the RZ modes are added again
+    varnames.resize(m_num_user_varnames);
     nlev = warpx.finestLevel() + 1;
     // Initialize vector of pointers to the fields requested by the user.
     all_field_functors.resize( nlev );
     mf_avg.resize( nlev );
+    m_rho_new.resize( nlev );
 
     for ( int lev=0; lev<nlev; lev++ ){
         all_field_functors[lev].resize( varnames.size() );
@@ -90,8 +108,8 @@ Diagnostics::InitData ()
             } else if ( varnames[comp] == "rho" ){
                 // rho_new is stored in component 1 of rho_fp when using PSATD
 #ifdef WARPX_USE_PSATD
-                MultiFab* rho_new = new MultiFab(*warpx.get_pointer_rho_fp(lev), amrex::make_alias, 1, 1);
-                all_field_functors[lev][comp] = new CellCenterFunctor(rho_new, lev);
+                m_rho_new[lev].reset(new MultiFab(*warpx.get_pointer_rho_fp(lev), amrex::make_alias, 1, 1));
+                all_field_functors[lev][comp] = new CellCenterFunctor(m_rho_new[lev].get(), lev);
 #else
                 all_field_functors[lev][comp] = new CellCenterFunctor(warpx.get_pointer_rho_fp(lev), lev);
 #endif
@@ -118,8 +136,6 @@ Diagnostics::InitData ()
                                warpx.DistributionMap(lev),
                                varnames.size(), 0);
     }
-    // Construct Flush class. So far, only Plotfile is implemented.
-    m_flush_format = new FlushFormatPlotfile;
 }
 
 void
@@ -138,8 +154,8 @@ Diagnostics::ComputeAndPack ()
     warpx.FieldGather();
 
     // cell-center fields and store result in mf_avg.
-    int icomp_dst = 0;
     for(int lev=0; lev<nlev; lev++){
+        int icomp_dst = 0;
         for (int icomp=0, n=all_field_functors[0].size(); icomp<n; icomp++){
             // Call all functors in all_field_functors[lev]. Each of them computes
             // a diagnostics and writes in one or more components of the output
@@ -148,9 +164,9 @@ Diagnostics::ComputeAndPack ()
             // update the index of the next component to fill
             icomp_dst += all_field_functors[lev][icomp]->nComp();
         }
+        // Check that the proper number of components of mf_avg were updated.
+        AMREX_ALWAYS_ASSERT( icomp_dst == varnames.size() );
     }
-    // Check that the proper number of components of mf_avg were updated.
-    AMREX_ALWAYS_ASSERT( icomp_dst == varnames.size() );
 }
 
 void
@@ -239,13 +239,16 @@ ConstructTotalRZScalarField (MultiFab& scalar_total,
 /** \brief Takes an array of 3 MultiFab `vector_field`
  * (representing the x, y, z components of a vector),
  * averages it to the cell center, and stores the
- * resulting MultiFab in mf_avg (in the components dcomp to dcomp+2)
+ * resulting MultiFab in mf_avg (in the components dcomp to dcomp+2).
+ * If in_index is given, the box b of mf_avg is a subset of the box
+ * (*in_index)[b] of the fields instead of the same box.
  */
 void
 AverageAndPackVectorField( MultiFab& mf_avg,
                            const std::array< std::unique_ptr<MultiFab>, 3 >& vector_field,
                            const DistributionMapping& dm,
-                           const int dcomp, const int ngrow )
+                           const int dcomp, const int ngrow,
+                           const Vector<int>* in_index )
 {
 #ifndef WARPX_DIM_RZ
     (void)dm;
@@ -272,9 +275,15 @@ AverageAndPackVectorField( MultiFab& mf_avg,
     const std::array<std::unique_ptr<MultiFab>,3> &vector_total = vector_field;
 #endif
 
-    Average::ToCellCenter( mf_avg, *(vector_total[0]), dcomp  , ngrow );
-    Average::ToCellCenter( mf_avg, *(vector_total[1]), dcomp+1, ngrow );
-    Average::ToCellCenter( mf_avg, *(vector_total[2]), dcomp+2, ngrow );
+    if (in_index) {
+        Average::ToCellCenter( mf_avg, *(vector_total[0]), *in_index, dcomp  , ngrow );
+        Average::ToCellCenter( mf_avg, *(vector_total[1]), *in_index, dcomp+1, ngrow );
+        Average::ToCellCenter( mf_avg, *(vector_total[2]), *in_index, dcomp+2, ngrow );
+    } else {
+        Average::ToCellCenter( mf_avg, *(vector_total[0]), dcomp  , ngrow );
+        Average::ToCellCenter( mf_avg, *(vector_total[1]), dcomp+1, ngrow );
+        Average::ToCellCenter( mf_avg, *(vector_total[2]), dcomp+2, ngrow );
+    }
 }
 
 /** \brief Takes all of the components of the three fields and
@@ -300,13 +309,16 @@ AverageAndPackVectorFieldComponents (MultiFab& mf_avg,
 
 /** \brief Take a MultiFab `scalar_field`
  * averages it to the cell center, and stores the
- * resulting MultiFab in mf_avg (in the components dcomp)
+ * resulting MultiFab in mf_avg (in the components dcomp).
+ * If in_index is given, the box b of mf_avg is a subset of the box
+ * (*in_index)[b] of scalar_field instead of the same box.
  */
 void
 AverageAndPackScalarField (MultiFab& mf_avg,
                            const MultiFab & scalar_field,
                            const DistributionMapping& dm,
-                           const int dcomp, const int ngrow )
+                           const int dcomp, const int ngrow,
+                           const Vector<int>* in_index )
 {
 
 #ifdef WARPX_DIM_RZ
@@ -326,8 +338,19 @@ AverageAndPackScalarField (MultiFab& mf_avg,
     // Check the type of staggering of the 3-component `vector_field`
     // and average accordingly:
     // - Fully cell-centered field (no average needed; simply copy)
-    if ( scalar_total->is_cell_centered() ){
+    if ( scalar_total->is_cell_centered() && in_index ){
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+        for (MFIter mfi(mf_avg, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box bx = mfi.growntilebox(ngrow);
+            mf_avg[mfi].copy<RunOn::Device>((*scalar_total)[(*in_index)[mfi.index()]],
+                                            bx, 0, bx, dcomp, 1);
+        }
+    } else if ( scalar_total->is_cell_centered() ){
         MultiFab::Copy( mf_avg, *scalar_total, 0, dcomp, 1, ngrow);
+    } else if ( scalar_total->is_nodal() && in_index ){
+        Average::ToCellCenter( mf_avg, *scalar_total, *in_index, dcomp, ngrow, 0, 1 );
     } else if ( scalar_total->is_nodal() ){
         // - Fully nodal
         Average::ToCellCenter( mf_avg, *scalar_total, dcomp, ngrow, 0, 1 );
@@ -27,6 +27,14 @@ MultiDiagnostics::InitData ()
     }
 }
 
+void
+MultiDiagnostics::InitializeFieldFunctors ()
+{
+    for( auto& diag : alldiags ){
+        diag->InitializeFieldFunctors();
+    }
+}
+
 void
 MultiDiagnostics::ReadParameters ()
 {
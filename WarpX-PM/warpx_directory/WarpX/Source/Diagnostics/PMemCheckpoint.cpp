@@ -0,0 +1,378 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "PMemCheckpoint.H"
+#include "WarpX.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace amrex;
+
+namespace
+{
+    const std::string slot_names[2] {"slot0", "slot1"};
+    constexpr Long magic = 0x57504d454d434b31; // "WPMEMCK1"
+
+    std::string DataFileName (const std::string& slot)
+    {
+        return amrex::Concatenate(slot + "/Data_", ParallelDescriptor::MyProc(), 5);
+    }
+
+    void SyncFile (const std::string& name)
+    {
+        const int fd = ::open(name.c_str(), O_RDONLY);
+        if (fd < 0 || ::fsync(fd) != 0) {
+            amrex::Abort("PMemCheckpoint: failed to sync " + name);
+        }
+        ::close(fd);
+    }
+
+    //! A piece of the raw data, and where it goes
+    struct Chunk
+    {
+        char* dst;
+        const char* src;
+        std::size_t nbytes;
+    };
+
+    void CopyChunks (const Vector<Chunk>& chunks)
+    {
+        Gpu::synchronize();
+        const int n = chunks.size();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < n; ++i) {
+            std::memcpy(chunks[i].dst, chunks[i].src, chunks[i].nbytes);
+        }
+    }
+
+    /** Visit the raw data of this process, in the order of the file: the
+     *  fabs of the fields, then the particle tiles of each species. meta
+     *  describes it, and is written at the beginning of the file. */
+    template <class F>
+    void ForEachChunk (const Vector<MultiFab*>& fields, MultiParticleContainer& mypc,
+                       Vector<Long>& meta, F&& f)
+    {
+        using ParticleType = WarpXParticleContainer::ParticleType;
+
+        meta.push_back(magic);
+        meta.push_back(fields.size());
+        for (MultiFab* mf : fields) {
+            meta.push_back(mf->local_size());
+            for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+                FArrayBox& fab = (*mf)[mfi];
+                meta.push_back(fab.nBytes());
+                f(reinterpret_cast<char*>(fab.dataPtr()), fab.nBytes());
+            }
+        }
+
+        meta.push_back(mypc.nSpecies());
+        for (int i = 0; i < mypc.nSpecies(); ++i) {
+            WarpXParticleContainer& pc = mypc.GetParticleContainer(i);
+            meta.push_back(pc.GetParticles().size());
+            for (auto& pmap : pc.GetParticles()) {
+                meta.push_back(pmap.size());
+                for (auto& kv : pmap) {
+                    auto& ptile = kv.second;
+                    const std::size_t np = ptile.numParticles();
+                    const int nreal = ptile.NumRealComps();
+                    const int nint = ptile.NumIntComps();
+                    meta.push_back(kv.first.first);
+                    meta.push_back(kv.first.second);
+                    meta.push_back(np);
+                    meta.push_back(nreal);
+                    meta.push_back(nint);
+                    if (np == 0) continue;
+                    f(reinterpret_cast<char*>(ptile.GetArrayOfStructs()().dataPtr()),
+                      np*sizeof(ParticleType));
+                    auto& soa = ptile.GetStructOfArrays();
+                    for (int comp = 0; comp < nreal; ++comp) {
+                        f(reinterpret_cast<char*>(soa.GetRealData(comp).dataPtr()),
+                          np*sizeof(ParticleReal));
+                    }
+                    for (int comp = 0; comp < nint; ++comp) {
+                        f(reinterpret_cast<char*>(soa.GetIntData(comp).dataPtr()),
+                          np*sizeof(int));
+                    }
+                }
+            }
+        }
+    }
+}
+
+PMemCheckpoint::PMemCheckpoint (const std::string& dir)
+    : m_dir(dir)
+{
+    if (ParallelDescriptor::IOProcessor()) {
+        for (const auto& name : slot_names) {
+            if (!amrex::UtilCreateDirectory(m_dir + "/" + name, 0755)) {
+                amrex::CreateDirectoryFailed(m_dir + "/" + name);
+            }
+        }
+    }
+    ParallelDescriptor::Barrier();
+
+    // Never overwrite the last complete checkpoint first
+    m_next = (LatestSlot(m_dir) == m_dir + "/" + slot_names[0]) ? 1 : 0;
+}
+
+PMemCheckpoint::~PMemCheckpoint ()
+{
+    for (auto& m : m_map) {
+        if (m.data) ::munmap(m.data, m.size);
+    }
+}
+
+std::string
+PMemCheckpoint::NextSlot () const
+{
+    return m_dir + "/" + slot_names[m_next];
+}
+
+void
+PMemCheckpoint::Map (int slot, std::size_t size)
+{
+    Mapping& m = m_map[slot];
+    if (m.data && m.size == size) return;
+
+    if (m.data) {
+        ::munmap(m.data, m.size);
+        m.data = nullptr;
+        m.size = 0;
+    }
+
+    const std::string name = DataFileName(m_dir + "/" + slot_names[slot]);
+    const int fd = ::open(name.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) amrex::FileOpenFailed(name);
+    if (::ftruncate(fd, size) != 0) {
+        amrex::Abort("PMemCheckpoint: failed to resize " + name);
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        amrex::Abort("PMemCheckpoint: failed to map " + name);
+    }
+    m.data = static_cast<char*>(p);
+    m.size = size;
+}
+
+void
+PMemCheckpoint::Write (const Vector<MultiFab*>& fields, MultiParticleContainer& mypc)
+{
+    WARPX_PROFILE("PMemCheckpoint::Write()");
+
+    Vector<Long> meta;
+    meta.push_back(0); // size of meta
+    Vector<Chunk> chunks;
+    std::size_t nbytes = 0;
+    ForEachChunk(fields, mypc, meta,
+                 [&] (char* p, std::size_t n) {
+                     chunks.push_back(Chunk{nullptr, p, n});
+                     nbytes += n;
+                 });
+    meta.push_back(WarpXParticleContainer::ParticleType::NextID());
+    WarpXParticleContainer::ParticleType::NextID(meta.back());
+    meta[0] = meta.size();
+
+    const std::size_t meta_bytes = meta.size()*sizeof(Long);
+    Map(m_next, meta_bytes + nbytes);
+    char* data = m_map[m_next].data;
+
+    std::memcpy(data, meta.dataPtr(), meta_bytes);
+    char* dst = data + meta_bytes;
+    for (auto& c : chunks) {
+        c.dst = dst;
+        dst += c.nbytes;
+    }
+    CopyChunks(chunks);
+
+    if (::msync(data, m_map[m_next].size, MS_SYNC) != 0) {
+        amrex::Abort("PMemCheckpoint: failed to flush " + DataFileName(NextSlot()));
+    }
+}
+
+void
+PMemCheckpoint::Commit ()
+{
+    WARPX_PROFILE("PMemCheckpoint::Commit()");
+
+    // All the data of the slot is flushed before Latest names it.
+    ParallelDescriptor::Barrier();
+
+    if (ParallelDescriptor::IOProcessor()) {
+        SyncFile(NextSlot() + "/WarpXHeader");
+        SyncFile(NextSlot() + "/DistributionMaps");
+
+        const std::string latest = m_dir + "/Latest";
+        const std::string tmp = latest + ".tmp";
+        {
+            std::ofstream os(tmp, std::ofstream::out | std::ofstream::trunc);
+            if (!os.good()) amrex::FileOpenFailed(tmp);
+            os << slot_names[m_next] << "\n";
+        }
+        SyncFile(tmp);
+        if (std::rename(tmp.c_str(), latest.c_str()) != 0) {
+            amrex::Abort("PMemCheckpoint: failed to rename " + tmp);
+        }
+        SyncFile(m_dir);
+    }
+
+    m_next = 1 - m_next;
+}
+
+std::string
+PMemCheckpoint::LatestSlot (const std::string& dir)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(dir + "/Latest", buf, false);
+    if (buf.empty()) return std::string();
+
+    std::istringstream is(buf.dataPtr());
+    std::string name;
+    is >> name;
+    for (const auto& s : slot_names) {
+        if (name == s) return dir + "/" + name;
+    }
+    return std::string();
+}
+
+void
+PMemCheckpoint::Read (const std::string& slot, const Vector<MultiFab*>& fields,
+                      MultiParticleContainer& mypc)
+{
+    WARPX_PROFILE("PMemCheckpoint::Read()");
+
+    const std::string name = DataFileName(slot);
+    const int fd = ::open(name.c_str(), O_RDONLY);
+    if (fd < 0) amrex::FileOpenFailed(name);
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Long))) {
+        amrex::Abort("PMemCheckpoint: invalid file " + name);
+    }
+    const std::size_t size = st.st_size;
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        amrex::Abort("PMemCheckpoint: failed to map " + name);
+    }
+    const char* data = static_cast<const char*>(p);
+    const Long* saved = reinterpret_cast<const Long*>(data);
+    const Long nmeta = saved[0];
+
+    // Define the particle tiles as they were saved, and rebuild meta from
+    // the current data, which must then match the saved one.
+    Long pos = 1;
+    if (nmeta <= 3 || nmeta*sizeof(Long) > size || saved[1] != magic) {
+        amrex::Abort("PMemCheckpoint: invalid file " + name);
+    }
+    pos += 2 + fields.size();
+    for (MultiFab* mf : fields) {
+        pos += mf->local_size();
+    }
+    if (pos >= nmeta || saved[pos] != mypc.nSpecies()) {
+        amrex::Abort("PMemCheckpoint: the fields or species do not match the checkpoint " + slot);
+    }
+    ++pos;
+    // The n entries from pos must be in the metadata, before the last one
+    // (the next particle id)
+    auto check_meta = [&] (Long n) {
+        if (pos + n >= nmeta) {
+            amrex::Abort("PMemCheckpoint: the metadata of " + name
+                         + " is truncated or does not match the checkpoint");
+        }
+    };
+    for (int i = 0; i < mypc.nSpecies(); ++i) {
+        WarpXParticleContainer& pc = mypc.GetParticleContainer(i);
+        check_meta(1);
+        const int nlevs = saved[pos++];
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nlevs == pc.GetParticles().size(),
+                                         "PMemCheckpoint: the particle levels do not match the checkpoint");
+        for (int lev = 0; lev < nlevs; ++lev) {
+            check_meta(1);
+            const Long ntiles = saved[pos++];
+            for (Long t = 0; t < ntiles; ++t) {
+                check_meta(5);
+                const int grid = saved[pos];
+                const int tile = saved[pos+1];
+                const Long np = saved[pos+2];
+                if (np < 0) {
+                    amrex::Abort("PMemCheckpoint: invalid number of particles in " + name);
+                }
+                pos += 5;
+                pc.DefineAndReturnParticleTile(lev, grid, tile).resize(np);
+            }
+        }
+    }
+
+    Vector<Long> meta;
+    meta.push_back(nmeta);
+    Vector<Chunk> chunks;
+    const char* src = data + nmeta*sizeof(Long);
+    ForEachChunk(fields, mypc, meta,
+                 [&] (char* dst, std::size_t n) {
+                     chunks.push_back(Chunk{dst, src, n});
+                     src += n;
+                 });
+    meta.push_back(saved[nmeta-1]);
+
+    if (meta.size() != nmeta || !std::equal(meta.begin(), meta.end(), saved) ||
+        src != data + size) {
+        amrex::Abort("PMemCheckpoint: the data does not match the checkpoint " + slot);
+    }
+    CopyChunks(chunks);
+
+    WarpXParticleContainer::ParticleType::NextID(saved[nmeta-1]);
+
+    ::munmap(p, size);
+}
+
+void
+PMemCheckpoint::WriteDistributionMaps (const std::string& slot,
+                                       const Vector<DistributionMapping>& dms)
+{
+    const std::string name = slot + "/DistributionMaps";
+    std::ofstream os(name, std::ofstream::out | std::ofstream::trunc);
+    if (!os.good()) amrex::FileOpenFailed(name);
+
+    os << ParallelDescriptor::NProcs() << "\n" << dms.size() << "\n";
+    for (const auto& dm : dms) {
+        dm.writeOn(os);
+        os << "\n";
+    }
+}
+
+Vector<DistributionMapping>
+PMemCheckpoint::ReadDistributionMaps (const std::string& slot)
+{
+    Vector<char> buf;
+    ParallelDescriptor::ReadAndBcastFile(slot + "/DistributionMaps", buf);
+    std::istringstream is(buf.dataPtr());
+
+    int nprocs, nlevs;
+    is >> nprocs >> nlevs;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nprocs == ParallelDescriptor::NProcs(),
+        "warpx.pmem_restart needs the number of MPI processes of the checkpoint");
+
+    Vector<DistributionMapping> dms(nlevs);
+    for (auto& dm : dms) {
+        dm.readFrom(is);
+    }
+    return dms;
+}
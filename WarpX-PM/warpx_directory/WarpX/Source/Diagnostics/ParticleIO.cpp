@@ -98,6 +98,7 @@ MultiParticleContainer::WritePlotFile (const std::string& dir) const
             real_names.push_back("momentum_y");
             real_names.push_back("momentum_z");
 
+#ifndef WARPX_NO_PARTICLE_FIELDS
             real_names.push_back("Ex");
             real_names.push_back("Ey");
             real_names.push_back("Ez");
@@ -105,6 +106,7 @@ MultiParticleContainer::WritePlotFile (const std::string& dir) const
             real_names.push_back("Bx");
             real_names.push_back("By");
             real_names.push_back("Bz");
+#endif
 
 #ifdef WARPX_DIM_RZ
             real_names.push_back("theta");
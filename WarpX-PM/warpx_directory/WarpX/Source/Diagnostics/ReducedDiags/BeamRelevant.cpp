@@ -7,9 +7,9 @@
 #include "BeamRelevant.H"
 #include "WarpX.H"
 #include "Utils/WarpXConst.H"
+#include "ParticleMoments.H"
 
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
 
 #include <iostream>
 #include <cmath>
@@ -152,201 +152,70 @@ void BeamRelevant::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        // weight sum
-        Real w_sum = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::w); });
-
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum(w_sum);
-
-        if (w_sum < std::numeric_limits<Real>::min() )
-        {
-            for (int i = 0; i < m_data.size(); ++i) { m_data[i] = 0.0; }
-            return;
-        }
-
-        // x mean
-        Real x_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(0) * p.rdata(PIdx::w); });
-
+        // compute the means and the (co)variances of the positions, the
+        // momenta and gamma in one sweep over the particles, and combine
+        // the results of all the MPI ranks in one collective operation
 #if (AMREX_SPACEDIM == 3)
-        // y mean
-        Real y_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(1) * p.rdata(PIdx::w); });
-#endif
-
-        // z mean
-        Real z_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(index_z) * p.rdata(PIdx::w); });
-
-        // ux mean
-        Real ux_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::ux) * p.rdata(PIdx::w); });
-
-        // uy mean
-        Real uy_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::uy) * p.rdata(PIdx::w); });
-
-        // uz mean
-        Real uz_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::uz) * p.rdata(PIdx::w); });
-
-        // gamma mean
-        Real gm_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real ux = p.rdata(PIdx::ux);
-            Real uy = p.rdata(PIdx::uy);
-            Real uz = p.rdata(PIdx::uz);
-            Real us = ux*ux + uy*uy + uz*uz;
-            return std::sqrt(1.0 + us*inv_c2) * p.rdata(PIdx::w);
-        });
-
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum(x_mean);  x_mean  /= w_sum;
-#if (AMREX_SPACEDIM == 3)
-        ParallelDescriptor::ReduceRealSum(y_mean);  y_mean  /= w_sum;
+        enum { ix, iy, iz, iux, iuy, iuz, igm, nv };
+#elif (AMREX_SPACEDIM == 2)
+        enum { ix, iz, iux, iuy, iuz, igm, nv };
 #endif
-        ParallelDescriptor::ReduceRealSum(z_mean);  z_mean  /= w_sum;
-        ParallelDescriptor::ReduceRealSum(ux_mean); ux_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(uy_mean); uy_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(uz_mean); uz_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(gm_mean); gm_mean /= w_sum;
-
-        // x mean square
-        Real x_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(0)-x_mean) * (p.pos(0)-x_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-#if (AMREX_SPACEDIM == 3)
-        // y mean square
-        Real y_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(1)-y_mean) * (p.pos(1)-y_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#endif
-
-        // z mean square
-        Real z_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(index_z)-z_mean) * (p.pos(index_z)-z_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // ux mean square
-        Real ux_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::ux)-ux_mean) *
-                           (p.rdata(PIdx::ux)-ux_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // uy mean square
-        Real uy_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::uy)-uy_mean) *
-                           (p.rdata(PIdx::uy)-uy_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // uz mean square
-        Real uz_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::uz)-uz_mean) *
-                           (p.rdata(PIdx::uz)-uz_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // gamma mean square
-        Real gm_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        Vector<ParticleMoments<nv> > moments(1);
+        moments[0] = ComputeParticleMoments<nv>( myspc,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,nv>& a) -> Real
         {
             Real const ux = p.rdata(PIdx::ux);
             Real const uy = p.rdata(PIdx::uy);
             Real const uz = p.rdata(PIdx::uz);
             Real const us = ux*ux + uy*uy + uz*uz;
-            Real const gm = std::sqrt(1.0 + us*inv_c2);
-            Real const a  = (gm - gm_mean) * (gm - gm_mean);
-            return a * p.rdata(PIdx::w);
+            a[ix]  = p.pos(0);
+#if (AMREX_SPACEDIM == 3)
+            a[iy]  = p.pos(1);
+#endif
+            a[iz]  = p.pos(index_z);
+            a[iux] = ux;
+            a[iuy] = uy;
+            a[iuz] = uz;
+            a[igm] = std::sqrt(1.0 + us*inv_c2);
+            return p.rdata(PIdx::w);
         });
+        ReduceParticleMoments(moments, ParallelDescriptor::IOProcessorNumber());
+        auto const& mom = moments[0];
 
-        // x times ux
-        Real xux = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        // the results are only needed on the I/O processor
+        if (!ParallelDescriptor::IOProcessor()) { continue; }
+
+        if (mom.w < std::numeric_limits<Real>::min() )
         {
-            Real const a = (p.pos(0)-x_mean) * (p.rdata(PIdx::ux)-ux_mean);
-            return a * p.rdata(PIdx::w);
-        });
+            for (int i = 0; i < m_data.size(); ++i) { m_data[i] = 0.0; }
+            return;
+        }
 
+        Real const x_mean  = mom.mean[ix];
 #if (AMREX_SPACEDIM == 3)
-        // y times uy
-        Real yuy = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(1)-y_mean) * (p.rdata(PIdx::uy)-uy_mean);
-            return a * p.rdata(PIdx::w);
-        });
+        Real const y_mean  = mom.mean[iy];
 #endif
+        Real const z_mean  = mom.mean[iz];
+        Real const ux_mean = mom.mean[iux];
+        Real const uy_mean = mom.mean[iuy];
+        Real const uz_mean = mom.mean[iuz];
+        Real const gm_mean = mom.mean[igm];
 
-        // z times uz
-        Real zuz = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(index_z)-z_mean) * (p.rdata(PIdx::uz)-uz_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum
-            ( x_ms, ParallelDescriptor::IOProcessorNumber());
-        x_ms /= w_sum;
+        Real const x_ms  = mom.Variance(ix);
 #if (AMREX_SPACEDIM == 3)
-        ParallelDescriptor::ReduceRealSum
-            ( y_ms, ParallelDescriptor::IOProcessorNumber());
-        y_ms /= w_sum;
+        Real const y_ms  = mom.Variance(iy);
 #endif
-        ParallelDescriptor::ReduceRealSum
-            ( z_ms, ParallelDescriptor::IOProcessorNumber());
-        z_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (ux_ms, ParallelDescriptor::IOProcessorNumber());
-        ux_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (uy_ms, ParallelDescriptor::IOProcessorNumber());
-        uy_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (uz_ms, ParallelDescriptor::IOProcessorNumber());
-        uz_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (gm_ms, ParallelDescriptor::IOProcessorNumber());
-        gm_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (   xux, ParallelDescriptor::IOProcessorNumber());
-        xux /= w_sum;
+        Real const z_ms  = mom.Variance(iz);
+        Real const ux_ms = mom.Variance(iux);
+        Real const uy_ms = mom.Variance(iuy);
+        Real const uz_ms = mom.Variance(iuz);
+        Real const gm_ms = mom.Variance(igm);
+
+        Real const xux = mom.Covariance(ix, iux);
 #if (AMREX_SPACEDIM == 3)
-        ParallelDescriptor::ReduceRealSum
-            (   yuy, ParallelDescriptor::IOProcessorNumber());
-        yuy /= w_sum;
+        Real const yuy = mom.Covariance(iy, iuy);
 #endif
-        ParallelDescriptor::ReduceRealSum
-            (   zuz, ParallelDescriptor::IOProcessorNumber());
-        zuz /= w_sum;
+        Real const zuz = mom.Covariance(iz, iuz);
 
         // save data
 #if (AMREX_SPACEDIM == 3)
@@ -8,6 +8,8 @@
 #include "LoadBalanceCosts.H"
 #include "WarpX.H"
 
+#include <array>
+#include <string>
 
 using namespace amrex;
 
@@ -15,7 +17,10 @@ using namespace amrex;
 LoadBalanceCosts::LoadBalanceCosts (std::string rd_name)
     : ReducedDiags{rd_name}
 {
-
+    if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+    {
+        m_nDataFields += CostKernel::NKernels;
+    }
 }
 
 // function that gathers costs
@@ -24,38 +29,52 @@ void LoadBalanceCosts::ComputeDiags (int step)
     // get WarpX class object
     auto& warpx = WarpX::GetInstance();
 
-    // for now, costs reduced diagnostic only works with `costs_heuristic`,
-    // but this will work for timer based costs as well after changing from
-    // multifab to vector
-    const amrex::Vector<amrex::Real>* cost_heuristic = warpx.getCostsHeuristic(0);
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(cost_heuristic != nullptr,
-        "LoadBalanceCosts reduced diagnostic works only with heuristic costs update.");
-
     // judge if the diags should be done
     // costs is initialized only if we're doing load balance
     if ( ((step+1) % m_freq != 0) || warpx.get_load_balance_int() < 1 ) { return; }
 
+    const bool use_timers =
+        (warpx.load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers);
+
     // get number of boxes over all levels
     auto nLevels = warpx.finestLevel() + 1;
     int nBoxes = 0;
     for (int lev = 0; lev < nLevels; ++lev)
     {
-        const amrex::Vector<amrex::Real>* cost_heuristic = warpx.getCostsHeuristic(lev);
-        nBoxes += cost_heuristic->size();
+        nBoxes += warpx.boxArray(lev).size();
     }
 
     // keep track of the max number of boxes, this is needed later on to fill
     // the jagged array (in case each step does not have the same number of boxes)
     m_nBoxesMax = std::max(m_nBoxesMax, nBoxes);
 
+    // the decisions of the load balance are saved for all the possible levels,
+    // so that they are at the same columns at all steps
+    m_nLevelsMax = warpx.maxLevel() + 1;
+    const int nDecisions = m_nDecisionFields*m_nLevelsMax;
+
     // resize and clear data array
-    const size_t dataSize = m_nDataFields*nBoxes;
+    const size_t dataSize = nDecisions + m_nDataFields*nBoxes;
     m_data.resize(dataSize, 0.0);
     m_data.assign(dataSize, 0.0);
 
-    // read in WarpX costs_heuristic to local copy
+    // read in WarpX costs to local copy: costs_heuristic, or the cost of
+    // each box and of each of its kernel classes, summed over the processes
     amrex::Vector<std::unique_ptr<amrex::Vector<amrex::Real> > > costs_heuristic;
-    if (warpx.load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic)
+    amrex::Vector<amrex::Vector<amrex::Real> > box_costs, kernel_costs;
+    if (use_timers)
+    {
+        box_costs.resize(nLevels);
+        kernel_costs.resize(nLevels);
+        for (int lev = 0; lev < nLevels; ++lev)
+        {
+            const CostLedger* cost = warpx.getCosts(lev);
+            AMREX_ALWAYS_ASSERT(cost != nullptr);
+            box_costs[lev] = cost->BoxCosts();
+            kernel_costs[lev] = cost->KernelCosts();
+        }
+    }
+    else
     {
         costs_heuristic.resize(nLevels);
         for (int lev = 0; lev < nLevels; ++lev)
@@ -68,7 +87,7 @@ void LoadBalanceCosts::ComputeDiags (int step)
     }
 
     // keeps track of correct index in array over all boxes on all levels
-    int shift = 0;
+    int shift = nDecisions;
 
     // save data
     for (int lev = 0; lev < nLevels; ++lev)
@@ -78,23 +97,47 @@ void LoadBalanceCosts::ComputeDiags (int step)
         for (MFIter mfi(Ex, false); mfi.isValid(); ++mfi)
         {
             const Box& tbx = mfi.tilebox();
-            m_data[shift + mfi.index()*m_nDataFields + 0] = (*costs_heuristic[lev])[mfi.index()];
-            m_data[shift + mfi.index()*m_nDataFields + 1] = dm[mfi.index()];
-            m_data[shift + mfi.index()*m_nDataFields + 2] = lev;
-            m_data[shift + mfi.index()*m_nDataFields + 3] = tbx.loVect()[0];
-            m_data[shift + mfi.index()*m_nDataFields + 4] = tbx.loVect()[1];
-            m_data[shift + mfi.index()*m_nDataFields + 5] = tbx.loVect()[2];
+            const int i = mfi.index();
+            m_data[shift + i*m_nDataFields + 0] = use_timers ? box_costs[lev][i]
+                                                             : (*costs_heuristic[lev])[i];
+            m_data[shift + i*m_nDataFields + 1] = dm[i];
+            m_data[shift + i*m_nDataFields + 2] = lev;
+            m_data[shift + i*m_nDataFields + 3] = tbx.loVect()[0];
+            m_data[shift + i*m_nDataFields + 4] = tbx.loVect()[1];
+            m_data[shift + i*m_nDataFields + 5] = tbx.loVect()[2];
+            if (use_timers)
+            {
+                for (int kernel = 0; kernel < CostKernel::NKernels; ++kernel)
+                {
+                    m_data[shift + i*m_nDataFields + 6 + kernel] =
+                        kernel_costs[lev][i*CostKernel::NKernels + kernel];
+                }
+            }
         }
 
         // we looped through all the boxes on level lev, update the shift index
-        shift += m_nDataFields*(costs_heuristic[lev]->size());
+        shift += m_nDataFields*warpx.boxArray(lev).size();
     }
 
     // parallel reduce to IO proc and get data over all procs
     ParallelDescriptor::ReduceRealSum(m_data.data(), m_data.size(), ParallelDescriptor::IOProcessorNumber());
 
+    // the decisions are the same on all the processes
+    for (int lev = 0; lev < nLevels; ++lev)
+    {
+        const LoadBalanceDecision& decision = warpx.getLoadBalanceDecision(lev);
+        m_data[lev*m_nDecisionFields + 0] = decision.current_efficiency;
+        m_data[lev*m_nDecisionFields + 1] = decision.proposed_efficiency;
+        m_data[lev*m_nDecisionFields + 2] = decision.adopted;
+        m_data[lev*m_nDecisionFields + 3] = decision.boxes_moved;
+        m_data[lev*m_nDecisionFields + 4] = decision.bytes_moved;
+    }
+
     /* m_data now contains up-to-date values for:
-     *  [[cost, proc, lev, i_low, j_low, k_low] of box 0 at level 0,
+     *  [[current_efficiency, proposed_efficiency, adopted, boxes_moved, bytes_moved] at level 0,
+     *   ...
+     *   [current_efficiency, proposed_efficiency, adopted, boxes_moved, bytes_moved] at max level,
+     *   [cost, proc, lev, i_low, j_low, k_low] of box 0 at level 0,
      *   [cost, proc, lev, i_low, j_low, k_low] of box 1 at level 0,
      *   [cost, proc, lev, i_low, j_low, k_low] of box 2 at level 0,
      *   ...
@@ -122,32 +165,53 @@ void LoadBalanceCosts::WriteToFile (int step) const
         std::string fileTmpName = m_path + m_rd_name + ".tmp." + m_extension;
         std::ofstream ofs(fileTmpName, std::ofstream::out);
         // write header row
-        // for each box on each level we saved 6 data fields: [cost, proc, lev, i_low, j_low, k_low])
+        // for each box on each level we saved 6 data fields: [cost, proc, lev, i_low, j_low, k_low],
+        // followed with timer-based costs by the cost of each kernel class
         ofs << "#";
         ofs << "[1]step()";
         ofs << m_sep;
         ofs << "[2]time(s)";
 
+        const int nDecisions = m_nDecisionFields*m_nLevelsMax;
+        const std::array<std::string, 5> decisionNames = {{"current_efficiency()",
+            "proposed_efficiency()", "adopted()", "boxes_moved()", "bytes_moved(B)"}};
+        for (int lev = 0; lev < m_nLevelsMax; ++lev)
+        {
+            for (int i = 0; i < m_nDecisionFields; ++i)
+            {
+                ofs << m_sep;
+                ofs << "[" + std::to_string(3 + lev*m_nDecisionFields + i) + "]";
+                ofs << "lev" + std::to_string(lev) + "_" + decisionNames[i];
+            }
+        }
+
         for (int boxNumber=0; boxNumber<m_nBoxesMax; ++boxNumber)
         {
             ofs << m_sep;
-            ofs << "[" + std::to_string(3 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(3 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "cost_box_"+std::to_string(boxNumber)+"()";
             ofs << m_sep;
-            ofs << "[" + std::to_string(4 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(4 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "proc_box_"+std::to_string(boxNumber)+"()";
             ofs << m_sep;
-            ofs << "[" + std::to_string(5 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(5 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "lev_box_"+std::to_string(boxNumber)+"()";
             ofs << m_sep;
-            ofs << "[" + std::to_string(6 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(6 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "i_low_box_"+std::to_string(boxNumber)+"()";
             ofs << m_sep;
-            ofs << "[" + std::to_string(7 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(7 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "j_low_box_"+std::to_string(boxNumber)+"()";
             ofs << m_sep;
-            ofs << "[" + std::to_string(8 + m_nDataFields*boxNumber) + "]";
+            ofs << "[" + std::to_string(8 + nDecisions + m_nDataFields*boxNumber) + "]";
             ofs << "k_low_box_"+std::to_string(boxNumber)+"()";
+            for (int kernel = 0; kernel < m_nDataFields - 6; ++kernel)
+            {
+                ofs << m_sep;
+                ofs << "[" + std::to_string(9 + nDecisions + kernel + m_nDataFields*boxNumber) + "]";
+                ofs << "cost_" + std::string(CostKernel::Name(kernel))
+                    + "_box_" + std::to_string(boxNumber) + "(s)";
+            }
         }
         ofs << std::endl;
 
@@ -169,11 +233,12 @@ void LoadBalanceCosts::WriteToFile (int step) const
                 if (ss.peek() == m_sep[0]) ss.ignore();
             }
 
-            // 2 columns for step, time; then nBoxes*nDatafields columns for data;
-            // then fill the remaining columns (i.e., up to 2 + m_nBoxesMax*m_nDataFields)
+            // 2 columns for step, time; then nDecisions columns for the load balance
+            // decisions; then nBoxes*nDatafields columns for data; then fill the
+            // remaining columns (i.e., up to 2 + nDecisions + m_nBoxesMax*m_nDataFields)
             // with NaN, so the array is not jagged
             ofs << lineIn;
-            for (int i=0; i<(m_nBoxesMax*m_nDataFields - (cnt - 2)); ++i)
+            for (int i=0; i<(m_nBoxesMax*m_nDataFields - (cnt - 2 - nDecisions)); ++i)
             {
                 ofs << m_sep << "NaN";
             }
@@ -10,6 +10,7 @@
 #include "BeamRelevant.H"
 #include "ParticleEnergy.H"
 #include "FieldEnergy.H"
+#include "PoissonConvergence.H"
 #include "MultiReducedDiags.H"
 #include "AMReX_ParmParse.H"
 #include "AMReX_ParallelDescriptor.H"
@@ -67,6 +68,11 @@ MultiReducedDiags::MultiReducedDiags ()
             m_multi_rd[i_rd].reset
                 ( new ParticleHistogram(m_rd_names[i_rd]));
         }
+        else if (rd_type.compare("PoissonConvergence") == 0)
+        {
+            m_multi_rd[i_rd].reset
+                ( new PoissonConvergence(m_rd_names[i_rd]));
+        }
         else
         { Abort("No matching reduced diagnostics type found."); }
         // end if match diags
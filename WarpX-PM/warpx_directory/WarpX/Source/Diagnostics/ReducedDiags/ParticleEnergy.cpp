@@ -8,9 +8,9 @@
 #include "ParticleEnergy.H"
 #include "WarpX.H"
 #include "Utils/WarpXConst.H"
+#include "ParticleMoments.H"
 
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
 
 #include <iostream>
 #include <cmath>
@@ -96,6 +96,11 @@ void ParticleEnergy::ComputeDiags (int step)
     // speed of light squared
     auto c2 = PhysConst::c * PhysConst::c;
 
+    // compute the sum of the weights and the mean kinetic energy of each
+    // species in one sweep over its particles, and combine the results of
+    // all the species and all the MPI ranks in one collective operation
+    Vector<ParticleMoments<1> > moments(nSpecies);
+
     // loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
     {
@@ -107,42 +112,37 @@ void ParticleEnergy::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        // Use amex::ReduceSum to compute the sum of energies of all particles
-        // held by the current MPI rank, for this species. This involves a loop over all
-        // boxes held by this MPI rank.
-        auto Etot = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        moments[i_s] = ComputeParticleMoments<1>( myspc,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,1>& a) -> Real
         {
-            auto w  = p.rdata(PIdx::w);
             auto ux = p.rdata(PIdx::ux);
             auto uy = p.rdata(PIdx::uy);
             auto uz = p.rdata(PIdx::uz);
             auto us = (ux*ux + uy*uy + uz*uz);
-            return ( std::sqrt(us*c2 + c2*c2) - c2 ) * m * w;
-        });
-
-        // Same thing for the particles weights.
-        auto Wtot = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
+            a[0] = ( std::sqrt(us*c2 + c2*c2) - c2 ) * m;
             return p.rdata(PIdx::w);
         });
+    }
+    // end loop over species
 
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum
-            (Etot, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum
-            (Wtot, ParallelDescriptor::IOProcessorNumber());
+    // reduced over mpi ranks
+    ReduceParticleMoments(moments, ParallelDescriptor::IOProcessorNumber());
 
-        // save results for this species i_s into m_data
-        m_data[i_s+1] = Etot;
+    // save results for each species i_s into m_data
+    for (int i_s = 0; i_s < nSpecies; ++i_s)
+    {
+        auto const Wtot = moments[i_s].w;
         if ( Wtot > std::numeric_limits<Real>::min() )
-        { m_data[nSpecies+2+i_s] = Etot / Wtot; }
+        {
+            m_data[i_s+1] = moments[i_s].mean[0] * Wtot;
+            m_data[nSpecies+2+i_s] = moments[i_s].mean[0];
+        }
         else
-        { m_data[nSpecies+2+i_s] = 0.0; }
-
+        {
+            m_data[i_s+1] = 0.0;
+            m_data[nSpecies+2+i_s] = 0.0;
+        }
     }
-    // end loop over species
 
     // save total energy
     // loop over species
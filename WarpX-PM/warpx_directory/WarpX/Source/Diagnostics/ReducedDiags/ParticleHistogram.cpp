@@ -8,8 +8,9 @@
 #include "ParticleHistogram.H"
 #include "WarpX.H"
 #include "Utils/WarpXUtil.H"
+#include "Particles/Pusher/GetAndSetPosition.H"
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
+#include <AMReX_GpuContainers.H>
 #include <limits>
 
 using namespace amrex;
@@ -47,6 +48,22 @@ ParticleHistogram::ParticleHistogram (std::string rd_name)
     m_parser.reset(new ParserWrapper<m_nvars>(
         makeParser(function_string,{"t","x","y","z","ux","uy","uz"})));
 
+    // read the second quantity and its bin parameters, if any (2D histogram)
+    m_is_2d = pp.contains("histogram_function_2(t,x,y,z,ux,uy,uz)");
+    if (m_is_2d)
+    {
+        pp.get("bin_number_2",m_bin_num_2);
+        pp.get("bin_max_2",   m_bin_max_2);
+        pp.get("bin_min_2",   m_bin_min_2);
+        m_bin_size_2 = (m_bin_max_2 - m_bin_min_2) / m_bin_num_2;
+
+        std::string function_string_2 = "";
+        Store_parserString(pp,"histogram_function_2(t,x,y,z,ux,uy,uz)",
+                           function_string_2);
+        m_parser_2.reset(new ParserWrapper<m_nvars>(
+            makeParser(function_string_2,{"t","x","y","z","ux","uy","uz"})));
+    }
+
     // read normalization type
     std::string norm_string = "default";
     pp.query("normalization",norm_string);
@@ -80,8 +97,8 @@ ParticleHistogram::ParticleHistogram (std::string rd_name)
         Abort("Unknown species for ParticleHistogram reduced diagnostic.");
     }
 
-    // resize data array
-    m_data.resize(m_bin_num,0.0_rt);
+    // resize data array (the bins of the first quantity vary fastest)
+    m_data.resize(m_bin_num*m_bin_num_2,0.0_rt);
 
     if (ParallelDescriptor::IOProcessor())
     {
@@ -96,13 +113,32 @@ ParticleHistogram::ParticleHistogram (std::string rd_name)
             ofs << "[1]step()";
             ofs << m_sep;
             ofs << "[2]time(s)";
-            for (int i = 0; i < m_bin_num; ++i)
+            if (m_is_2d)
+            {
+                for (int j = 0; j < m_bin_num_2; ++j)
+                {
+                    for (int i = 0; i < m_bin_num; ++i)
+                    {
+                        ofs << m_sep;
+                        ofs << "[" + std::to_string(3+i+j*m_bin_num) + "]";
+                        Real b1 = m_bin_min + m_bin_size*(Real(i)+0.5_rt);
+                        Real b2 = m_bin_min_2 + m_bin_size_2*(Real(j)+0.5_rt);
+                        ofs << "bin" + std::to_string(1+i) + "_" + std::to_string(1+j)
+                                     + "=" + std::to_string(b1) + "_" + std::to_string(b2)
+                                     + "()";
+                    }
+                }
+            }
+            else
             {
-                ofs << m_sep;
-                ofs << "[" + std::to_string(3+i) + "]";
-                Real b = m_bin_min + m_bin_size*(Real(i)+0.5_rt);
-                ofs << "bin" + std::to_string(1+i)
-                             + "=" + std::to_string(b) + "()";
+                for (int i = 0; i < m_bin_num; ++i)
+                {
+                    ofs << m_sep;
+                    ofs << "[" + std::to_string(3+i) + "]";
+                    Real b = m_bin_min + m_bin_size*(Real(i)+0.5_rt);
+                    ofs << "bin" + std::to_string(1+i)
+                                 + "=" + std::to_string(b) + "()";
+                }
             }
             ofs << std::endl;
             // close file
@@ -130,41 +166,115 @@ void ParticleHistogram::ComputeDiags (int step)
     auto & mypc = warpx.GetPartContainer();
 
     // get WarpXParticleContainer class object
-    auto const & myspc = mypc.GetParticleContainer(m_selected_species_id);
+    auto & myspc = mypc.GetParticleContainer(m_selected_species_id);
 
-    using PType = typename WarpXParticleContainer::SuperParticleType;
-
-    // get parser
+    // get parsers
     ParserWrapper<m_nvars> *fun_partparser = m_parser.get();
+    ParserWrapper<m_nvars> *fun_partparser_2 = m_parser_2.get();
 
     // declare local variables
+    bool const is_2d = m_is_2d;
+    int const bin_num = m_bin_num;
+    int const bin_num_2 = m_bin_num_2;
     Real const bin_min  = m_bin_min;
     Real const bin_size = m_bin_size;
+    Real const bin_min_2  = m_is_2d ? m_bin_min_2  : 0.0_rt;
+    Real const bin_size_2 = m_is_2d ? m_bin_size_2 : 1.0_rt;
     const bool is_unity_particle_weight =
         (m_norm == NormalizationType::unity_particle_weight) ? true : false;
 
-    for ( int i = 0; i < m_bin_num; ++i )
+    // compute the histogram in a single pass over the particles: the
+    // quantities are evaluated once per particle, for all the particles of
+    // a tile at once with the batched parser, and the particle weight is
+    // added to its bin. Each thread fills its own histogram (on GPU, a
+    // single histogram is filled with atomic additions), and the
+    // histograms of the threads are then summed.
+    int const nbins = m_data.size();
+    std::fill(m_data.begin(), m_data.end(), 0.0_rt);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
     {
-        // compute the histogram
-        m_data[i] = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        Gpu::DeviceVector<Real> hist_thread(nbins, 0.0_rt);
+        Real* const AMREX_RESTRICT hist = hist_thread.dataPtr();
+        // arguments of the parsers and quantities of the particles of a tile
+        Gpu::DeviceVector<Real> args_tile;
+        Gpu::DeviceVector<Real> f_tile;
+        Gpu::DeviceVector<Real> f2_tile;
+
+        for (int lev = 0; lev <= myspc.finestLevel(); ++lev)
         {
-            auto const w  = p.rdata(PIdx::w);
-            auto const x  = p.pos(0);
-            auto const y  = p.pos(1);
-            auto const z  = p.pos(2);
-            auto const ux = p.rdata(PIdx::ux)/PhysConst::c;
-            auto const uy = p.rdata(PIdx::uy)/PhysConst::c;
-            auto const uz = p.rdata(PIdx::uz)/PhysConst::c;
-            auto const f = (*fun_partparser)(t,x,y,z,ux,uy,uz);
-            auto const f1 = bin_min + bin_size*i;
-            auto const f2 = bin_min + bin_size*(i+1);
-            if ( f > f1 && f < f2 ) {
-                if ( is_unity_particle_weight ) return 1.0_rt;
-                else return w;
-            } else return 0.0_rt;
-        });
+            for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti)
+            {
+                auto const GetPosition = GetParticlePosition(pti);
+                auto& attribs = pti.GetAttribs();
+                Real const * const AMREX_RESTRICT w  = attribs[PIdx::w].dataPtr();
+                Real const * const AMREX_RESTRICT uxp = attribs[PIdx::ux].dataPtr();
+                Real const * const AMREX_RESTRICT uyp = attribs[PIdx::uy].dataPtr();
+                Real const * const AMREX_RESTRICT uzp = attribs[PIdx::uz].dataPtr();
+                int const np = pti.numParticles();
+
+                args_tile.resize(m_nvars*np);
+                f_tile.resize(np);
+                f2_tile.resize(is_2d ? np : 0);
+                Real* const AMREX_RESTRICT args = args_tile.dataPtr();
+                Real* const AMREX_RESTRICT f = f_tile.dataPtr();
+                Real* const AMREX_RESTRICT f2 = f2_tile.dataPtr();
+
+                amrex::ParallelFor(np,
+                [=] AMREX_GPU_DEVICE (int ip)
+                {
+                    ParticleReal x, y, z;
+                    GetPosition(ip, x, y, z);
+                    args[ip     ] = t;
+                    args[ip+  np] = x;
+                    args[ip+2*np] = y;
+                    args[ip+3*np] = z;
+                    args[ip+4*np] = uxp[ip]/PhysConst::c;
+                    args[ip+5*np] = uyp[ip]/PhysConst::c;
+                    args[ip+6*np] = uzp[ip]/PhysConst::c;
+                });
+                fun_partparser->eval(np, args, args+np, args+2*np, args+3*np,
+                                     args+4*np, args+5*np, args+6*np, f);
+                if ( is_2d ) {
+                    fun_partparser_2->eval(np, args, args+np, args+2*np, args+3*np,
+                                           args+4*np, args+5*np, args+6*np, f2);
+                }
+
+                amrex::ParallelFor(np,
+                [=] AMREX_GPU_DEVICE (int ip)
+                {
+                    // bin index (written so that NaN values are discarded)
+                    Real const fi = amrex::Math::floor((f[ip] - bin_min)/bin_size);
+                    if ( !(fi >= 0.0_rt && fi < bin_num) ) return;
+                    int const i = static_cast<int>(fi);
+
+                    int j = 0;
+                    if ( is_2d ) {
+                        Real const fj = amrex::Math::floor((f2[ip] - bin_min_2)/bin_size_2);
+                        if ( !(fj >= 0.0_rt && fj < bin_num_2) ) return;
+                        j = static_cast<int>(fj);
+                    }
+
+                    Real const weight = is_unity_particle_weight ? 1.0_rt : w[ip];
+                    // not atomic on CPU, where each thread has its own histogram
+                    Gpu::Atomic::Add(&hist[i+j*bin_num], weight);
+                });
+            }
+        }
+
+        Gpu::HostVector<Real> hist_host(nbins);
+        Gpu::copy(Gpu::deviceToHost, hist_thread.begin(), hist_thread.end(), hist_host.begin());
+#ifdef _OPENMP
+#pragma omp critical (particle_histogram_reduce)
+#endif
+        for ( int i = 0; i < nbins; ++i )
+        {
+            m_data[i] += hist_host[i];
+        }
     }
+
     // reduced sum over mpi ranks
     ParallelDescriptor::ReduceRealSum
         (m_data.data(), m_data.size(), ParallelDescriptor::IOProcessorNumber());
@@ -173,11 +283,11 @@ void ParticleHistogram::ComputeDiags (int step)
     if ( m_norm == NormalizationType::max_to_unity )
     {
         Real f_max = 0.0_rt;
-        for ( int i = 0; i < m_bin_num; ++i )
+        for ( int i = 0; i < nbins; ++i )
         {
             if ( m_data[i] > f_max ) f_max = m_data[i];
         }
-        for ( int i = 0; i < m_bin_num; ++i )
+        for ( int i = 0; i < nbins; ++i )
         {
             if ( f_max > std::numeric_limits<Real>::min() ) m_data[i] /= f_max;
         }
@@ -188,11 +298,11 @@ void ParticleHistogram::ComputeDiags (int step)
     if ( m_norm == NormalizationType::area_to_unity )
     {
         Real f_area = 0.0_rt;
-        for ( int i = 0; i < m_bin_num; ++i )
+        for ( int i = 0; i < nbins; ++i )
         {
-            f_area += m_data[i] * m_bin_size;
+            f_area += m_data[i] * m_bin_size * bin_size_2;
         }
-        for ( int i = 0; i < m_bin_num; ++i )
+        for ( int i = 0; i < nbins; ++i )
         {
             if ( f_area > std::numeric_limits<Real>::min() ) m_data[i] /= f_area;
         }
@@ -0,0 +1,76 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PoissonConvergence.H"
+#include "WarpX.H"
+
+#include <fstream>
+
+using namespace amrex;
+
+// constructor
+PoissonConvergence::PoissonConvergence (std::string rd_name)
+: ReducedDiags{rd_name}
+{
+
+    // resize data array
+    m_data.resize(6,0.0);
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs;
+            ofs.open(m_path + m_rd_name + "." + m_extension,
+                std::ofstream::out | std::ofstream::app);
+            // write header row
+            ofs << "#";
+            ofs << "[1]step()";
+            ofs << m_sep;
+            ofs << "[2]time(s)";
+            ofs << m_sep;
+            ofs << "[3]solves()";
+            ofs << m_sep;
+            ofs << "[4]setups()";
+            ofs << m_sep;
+            ofs << "[5]iterations()";
+            ofs << m_sep;
+            ofs << "[6]last_iterations()";
+            ofs << m_sep;
+            ofs << "[7]last_initial_residual()";
+            ofs << m_sep;
+            ofs << "[8]last_final_residual()";
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+
+}
+// end constructor
+
+// function that gets the Poisson solver statistics
+void PoissonConvergence::ComputeDiags (int step)
+{
+
+    // Judge if the diags should be done
+    if ( (step+1) % m_freq != 0 ) { return; }
+
+    // get the statistics, identical on all the ranks
+    const PoissonSolverStats& stats = WarpX::GetInstance().getPoissonSolverStats();
+
+    // save data
+    m_data[0] = stats.num_solves;
+    m_data[1] = stats.num_setups;
+    m_data[2] = stats.num_iterations;
+    m_data[3] = stats.last_iterations;
+    m_data[4] = stats.last_initial_residual;
+    m_data[5] = stats.last_final_residual;
+
+}
+// end void PoissonConvergence::ComputeDiags
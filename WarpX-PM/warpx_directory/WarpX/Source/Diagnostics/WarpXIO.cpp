@@ -20,6 +20,8 @@
 #include <AMReX_FillPatchUtil_F.H>
 #include <AMReX_buildInfo.H>
 
+#include <set>
+
 #ifdef BL_USE_SENSEI_INSITU
 #   include <AMReX_AmrMeshInSituBridge.H>
 #endif
@@ -127,6 +129,17 @@ WarpX::WriteCheckPointFile() const
 
     amrex::Print() << "  Writing checkpoint " << checkpointname << "\n";
 
+    // The data of the fields and particles is copied to a stage, and written
+    // to the files by background threads after the previous checkpoint is
+    // complete. The headers are written now.
+    NFilesStage* stage = nullptr;
+    int istage = 0;
+    if (async_checkpoint) {
+        istage = (checkpoint_stage_writing == 0) ? 1 : 0;
+        stage = &checkpoint_stage[istage];
+        NFilesStage::SetActive(stage);
+    }
+
     const int nlevels = finestLevel()+1;
     amrex::PreBuildDirectorHierarchy(checkpointname, level_prefix, nlevels, true);
 
@@ -191,6 +204,71 @@ WarpX::WriteCheckPointFile() const
     mypc->Checkpoint(checkpointname);
 
     VisMF::SetHeaderVersion(current_version);
+
+    if (stage) {
+        NFilesStage::SetActive(nullptr);
+        FinishCheckPointFile();
+        stage->Launch(async_checkpoint_threads);
+        checkpoint_stage_writing = istage;
+    }
+}
+
+void
+WarpX::FinishCheckPointFile () const
+{
+    if (checkpoint_stage_writing < 0) return;
+    WARPX_PROFILE("WarpX::FinishCheckPointFile()");
+    checkpoint_stage[checkpoint_stage_writing].Finish();
+    checkpoint_stage_writing = -1;
+}
+
+Vector<MultiFab*>
+WarpX::PMemCheckpointFields ()
+{
+    Vector<MultiFab*> fields;
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        for (int i = 0; i < 3; ++i) {
+            fields.push_back(Efield_fp[lev][i].get());
+            fields.push_back(Bfield_fp[lev][i].get());
+            fields.push_back(current_fp[lev][i].get());
+        }
+        if (lev > 0) {
+            for (int i = 0; i < 3; ++i) {
+                fields.push_back(Efield_cp[lev][i].get());
+                fields.push_back(Bfield_cp[lev][i].get());
+                fields.push_back(current_cp[lev][i].get());
+            }
+        }
+        if (do_pml && pml[lev]) {
+            for (const auto& pml_fields : {pml[lev]->GetE_fp(), pml[lev]->GetB_fp(),
+                                           pml[lev]->GetE_cp(), pml[lev]->GetB_cp()}) {
+                for (MultiFab* mf : pml_fields) {
+                    if (mf) fields.push_back(mf);
+                }
+            }
+        }
+    }
+    return fields;
+}
+
+void
+WarpX::WritePMemCheckPoint ()
+{
+    WARPX_PROFILE("WarpX::WritePMemCheckPoint()");
+
+    if (!pmem_checkpoint) {
+        pmem_checkpoint.reset(new PMemCheckpoint(pmem_check_dir));
+    }
+    const std::string slot = pmem_checkpoint->NextSlot();
+
+    amrex::Print() << "  Writing checkpoint " << slot << " at step " << istep[0] << "\n";
+
+    WriteWarpXHeader(slot);
+    if (ParallelDescriptor::IOProcessor()) {
+        PMemCheckpoint::WriteDistributionMaps(slot, DistributionMap());
+    }
+    pmem_checkpoint->Write(PMemCheckpointFields(), *mypc);
+    pmem_checkpoint->Commit();
 }
 
 void
@@ -293,11 +371,19 @@ WarpX::InitFromCheckpoint ()
 
         ResetProbDomain(RealBox(prob_lo,prob_hi));
 
+        // The raw data in the files mapped in memory is that of the boxes
+        // of each process when it was written.
+        Vector<DistributionMapping> pmem_dms;
+        if (pmem_restart) {
+            pmem_dms = PMemCheckpoint::ReadDistributionMaps(restart_chkfile);
+        }
+
         for (int lev = 0; lev < nlevs; ++lev) {
             BoxArray ba;
             ba.readFrom(is);
             GotoNextLine(is);
-            DistributionMapping dm { ba, ParallelDescriptor::NProcs() };
+            DistributionMapping dm = pmem_restart ? pmem_dms[lev]
+                : DistributionMapping{ ba, ParallelDescriptor::NProcs() };
             SetBoxArray(lev, ba);
             SetDistributionMap(lev, dm);
             AllocLevelData(lev, ba, dm);
@@ -308,6 +394,20 @@ WarpX::InitFromCheckpoint ()
 
     const int nlevs = finestLevel()+1;
 
+    if (pmem_restart)
+    {
+        for (int lev = 1; lev < nlevs; ++lev) {
+            for (int i = 0; i < 3; ++i) {
+                Efield_aux[lev][i]->setVal(0.0);
+                Bfield_aux[lev][i]->setVal(0.0);
+            }
+        }
+        if (do_pml) InitPML();
+        mypc->AllocData();
+        PMemCheckpoint::Read(restart_chkfile, PMemCheckpointFields(), *mypc);
+        return;
+    }
+
     // Initialize the field data
     for (int lev = 0; lev < nlevs; ++lev)
     {
@@ -394,39 +494,87 @@ WarpX::InitFromCheckpoint ()
 
 
 std::unique_ptr<MultiFab>
-WarpX::GetCellCenteredData() {
-
-    WARPX_PROFILE("WarpX::GetCellCenteredData");
+WarpX::GetCellCenteredSlabData (int dir, const Vector<Real>& coords)
+{
+    WARPX_PROFILE("WarpX::GetCellCenteredSlabData");
 
     const int ng =  1;
     const int nc = 10;
 
+    // Cells of level 0 along dir that get_slice_data uses to interpolate at
+    // the coordinates: the cell of each coordinate and its two neighbors.
+    const Box& domain = geom[0].Domain();
+    const int nz = domain.length(dir);
+    std::set<int> cells;
+    for (const Real c : coords) {
+        const int k = static_cast<int>(std::floor((c - geom[0].ProbLo(dir))/geom[0].CellSize(dir)));
+        for (int kk = k-1; kk <= k+1; ++kk) {
+            if (geom[0].isPeriodic(dir)) {
+                cells.insert(domain.smallEnd(dir) + ((kk - domain.smallEnd(dir))%nz + nz)%nz);
+            } else if (kk >= domain.smallEnd(dir) && kk <= domain.bigEnd(dir)) {
+                cells.insert(kk);
+            }
+        }
+    }
+    // Slabs of contiguous cells
+    Vector<std::pair<int,int> > slabs;
+    for (const int k : cells) {
+        if (!slabs.empty() && k == slabs.back().second+1) {
+            slabs.back().second = k;
+        } else {
+            slabs.emplace_back(k, k);
+        }
+    }
+
     Vector<std::unique_ptr<MultiFab> > cc(finest_level+1);
 
+    IntVect ratio(1);
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        cc[lev].reset( new MultiFab(grids[lev], dmap[lev], nc, ng) );
+        if (lev > 0) ratio *= refRatio(lev-1);
+
+        // The intersections of the slabs with the grids, on the process of
+        // the grid they are part of so that they are filled without communication.
+        Vector<Box> boxes;
+        Vector<int> procs;
+        Vector<int> in_index;
+        for (const auto& slab : slabs) {
+            Box slab_box = geom[lev].Domain();
+            slab_box.setSmall(dir, slab.first*ratio[dir]);
+            slab_box.setBig(dir, (slab.second+1)*ratio[dir]-1);
+            for (const auto& isect : grids[lev].intersections(slab_box)) {
+                boxes.push_back(isect.second);
+                procs.push_back(dmap[lev][isect.first]);
+                in_index.push_back(isect.first);
+            }
+        }
+        // The finer levels are nested in this one
+        if (boxes.empty()) break;
+
+        const BoxArray ba(boxes.dataPtr(), boxes.size());
+        const DistributionMapping dm(std::move(procs));
+        cc[lev].reset(new MultiFab(ba, dm, nc, ng, MFInfo().SetArena(scratch_pool->TileArena())));
 
         int dcomp = 0;
         // first the electric field
-        AverageAndPackVectorField( *cc[lev], Efield_aux[lev], dmap[lev], dcomp, ng );
+        AverageAndPackVectorField( *cc[lev], Efield_aux[lev], dmap[lev], dcomp, ng, &in_index );
         dcomp += 3;
         // then the magnetic field
-        AverageAndPackVectorField( *cc[lev], Bfield_aux[lev], dmap[lev], dcomp, ng );
+        AverageAndPackVectorField( *cc[lev], Bfield_aux[lev], dmap[lev], dcomp, ng, &in_index );
         dcomp += 3;
         // then the current density
-        AverageAndPackVectorField( *cc[lev], current_fp[lev], dmap[lev], dcomp, ng );
+        AverageAndPackVectorField( *cc[lev], current_fp[lev], dmap[lev], dcomp, ng, &in_index );
         dcomp += 3;
         // then the charge density
         const std::unique_ptr<MultiFab>& charge_density = mypc->GetChargeDensity(lev);
-        AverageAndPackScalarField( *cc[lev], *charge_density, dmap[lev], dcomp, ng );
+        AverageAndPackScalarField( *cc[lev], *charge_density, dmap[lev], dcomp, ng, &in_index );
 
         cc[lev]->FillBoundary(geom[lev].periodicity());
     }
 
     for (int lev = finest_level; lev > 0; --lev)
     {
-        amrex::average_down(*cc[lev], *cc[lev-1], 0, nc, refRatio(lev-1));
+        if (cc[lev]) amrex::average_down(*cc[lev], *cc[lev-1], 0, nc, refRatio(lev-1));
     }
 
     return std::move(cc[0]);
@@ -224,6 +224,7 @@ WarpXOpenPMDPlot::WriteOpenPMDParticles(const std::unique_ptr<MultiParticleConta
       real_names.push_back("momentum_y");
       real_names.push_back("momentum_z");
 
+#ifndef WARPX_NO_PARTICLE_FIELDS
       real_names.push_back("E_x");
       real_names.push_back("E_y");
       real_names.push_back("E_z");
@@ -231,6 +232,7 @@ WarpXOpenPMDPlot::WriteOpenPMDParticles(const std::unique_ptr<MultiParticleConta
       real_names.push_back("B_x");
       real_names.push_back("B_y");
       real_names.push_back("B_z");
+#endif
 
 #ifdef WARPX_DIM_RZ
       real_names.push_back("theta");
@@ -61,12 +61,15 @@ WarpX::Evolve (int numsteps)
         if (warpx_py_beforestep) warpx_py_beforestep();
 #endif
 
-        MultiFab* cost = WarpX::getCosts(0);
+        // Follow the regions tagged for refinement
+        if (regrid_int > 0 && max_level > 0 && step > 0 && (step+1) % regrid_int == 0)
+        {
+            Regrid();
+        }
+
+        CostLedger* cost = WarpX::getCosts(0);
         amrex::Vector<amrex::Real>* cost_heuristic = WarpX::getCostsHeuristic(0);
         if (cost != nullptr || cost_heuristic != nullptr) {
-#ifdef WARPX_USE_PSATD
-            amrex::Abort("LoadBalance for PSATD: TODO");
-#endif
             if (step > 0 && (step+1) % load_balance_int == 0)
             {
                 LoadBalance();
@@ -76,12 +79,12 @@ WarpX::Evolve (int numsteps)
             }
             for (int lev = 0; lev <= finest_level; ++lev)
             {
-                MultiFab* cost = WarpX::getCosts(lev);
+                CostLedger* cost = WarpX::getCosts(lev);
                 if (cost)
                 {
                     // Perform running average of the costs
                     // (Giving more importance to most recent costs)
-                    cost->mult( (1. - 2./load_balance_int) );
+                    cost->Scale( (1. - 2./load_balance_int) );
                 }
             }
         }
@@ -170,11 +173,7 @@ WarpX::Evolve (int numsteps)
             (insitu_int > 0) && ((step+1) % insitu_int == 0);
 
         if (do_back_transformed_diagnostics) {
-            std::unique_ptr<MultiFab> cell_centered_data = nullptr;
-            if (WarpX::do_back_transformed_fields) {
-                cell_centered_data = GetCellCenteredData();
-            }
-            myBFD->writeLabFrameData(cell_centered_data.get(), *mypc, geom[0], cur_time, dt[0]);
+            myBFD->writeLabFrameData(*mypc, geom[0], cur_time, dt[0]);
         }
 
         bool move_j = is_synchronized || to_make_plot || to_write_openPMD || do_insitu;
@@ -209,6 +208,9 @@ WarpX::Evolve (int numsteps)
             }
         }
 
+        // Merge the particles, now that they are in their cells
+        mypc->doParticleMerging();
+
         bool to_sort = (sort_int > 0) && ((step+1) % sort_int == 0);
         if (to_sort) {
             amrex::Print() << "re-sorting particles \n";
@@ -222,6 +224,7 @@ WarpX::Evolve (int numsteps)
         amrex::Print()<< "Walltime = " << walltime
                       << " s; This step = " << walltime_end_step-walltime_beg_step
                       << " s; Avg. per step = " << walltime/(step+1) << " s\n";
+        if (verbose > 1) scratch_pool->PrintStats(step+1);
 
         // sync up time
         for (int i = 0; i <= max_level; ++i) {
@@ -278,6 +281,10 @@ WarpX::Evolve (int numsteps)
             WriteCheckPointFile();
         }
 
+        if (pmem_check_int > 0 && (step+1) % pmem_check_int == 0) {
+            WritePMemCheckPoint();
+        }
+
         if (cur_time >= stop_time - 1.e-3*dt[0]) {
             max_time_reached = true;
             break;
@@ -340,6 +347,9 @@ WarpX::Evolve (int numsteps)
 #ifdef BL_USE_SENSEI_INSITU
     insitu_bridge->finalize();
 #endif
+
+    // The last checkpoint is complete when Evolve returns
+    FinishCheckPointFile();
 }
 
 /* /brief Perform one PIC iteration, without subcycling
@@ -390,9 +400,7 @@ WarpX::OneStep_nosub (Real cur_time)
 
     //jie::deposit
     Real deposit_start=amrex::second();
-    SyncCurrent();
-
-    SyncRho();
+    SyncCurrentAndRho();
     Real deposit_end=amrex::second();
     Real deposit_timer = deposit_end-deposit_start;
     amrex::Print()<<"Deposit "<<deposit_timer<<std::endl;
@@ -498,8 +506,7 @@ WarpX::OneStep_sub1 (Real curtime)
 
     // i) Push particles and fields on the fine patch (first fine step)
     PushParticlesandDepose(fine_lev, curtime, DtType::FirstHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
+    RestrictFromFineToCoarsePatch(fine_lev, true, true);
     ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
     NodalSyncJ(fine_lev, PatchType::fine);
     ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, 2*ncomps);
@@ -554,8 +561,7 @@ WarpX::OneStep_sub1 (Real curtime)
 
     // iv) Push particles and fields on the fine patch (second fine step)
     PushParticlesandDepose(fine_lev, curtime+dt[fine_lev], DtType::SecondHalf);
-    RestrictCurrentFromFineToCoarsePatch(fine_lev);
-    RestrictRhoFromFineToCoarsePatch(fine_lev);
+    RestrictFromFineToCoarsePatch(fine_lev, true, true);
     ApplyFilterandSumBoundaryJ(fine_lev, PatchType::fine);
     NodalSyncJ(fine_lev, PatchType::fine);
     ApplyFilterandSumBoundaryRho(fine_lev, PatchType::fine, 0, ncomps);
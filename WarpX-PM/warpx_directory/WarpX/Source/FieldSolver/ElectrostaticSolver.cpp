@@ -6,8 +6,6 @@
  */
 
 #include <AMReX_ParallelDescriptor.H>
-#include <AMReX_MLMG.H>
-#include <AMReX_MLNodeTensorLaplacian.H>
 
 #include <WarpX.H>
 
@@ -18,8 +16,8 @@ WarpX::ComputeSpaceChargeField (bool const reset_fields)
 {
     if (reset_fields) {
         // Reset all E and B fields to 0, before calculating space-charge fields
-        const int num_levels = max_level + 1;
-        for (int lev = 0; lev <= max_level; lev++) {
+        const int num_levels = finest_level + 1;
+        for (int lev = 0; lev <= finest_level; lev++) {
             for (int comp=0; comp<3; comp++) {
                 Efield_fp[lev][comp]->setVal(0);
                 Bfield_fp[lev][comp]->setVal(0);
@@ -45,11 +43,11 @@ WarpX::AddSpaceChargeField (WarpXParticleContainer& pc)
 #endif
 
     // Allocate fields for charge and potential
-    const int num_levels = max_level + 1;
+    const int num_levels = finest_level + 1;
     Vector<std::unique_ptr<MultiFab> > rho(num_levels);
     Vector<std::unique_ptr<MultiFab> > phi(num_levels);
     const int ng = WarpX::nox;
-    for (int lev = 0; lev <= max_level; lev++) {
+    for (int lev = 0; lev <= finest_level; lev++) {
         BoxArray nba = boxArray(lev);
         nba.surroundingNodes();
         rho[lev].reset(new MultiFab(nba, dmap[lev], 1, ng)); // Make ng big enough/use rho from sim
@@ -69,7 +67,7 @@ WarpX::AddSpaceChargeField (WarpXParticleContainer& pc)
     for (Real& beta_comp : beta) beta_comp /= PhysConst::c; // Normalize
 
     // Compute the potential phi, by solving the Poisson equation
-    computePhi( rho, phi, beta, pc.self_fields_required_precision );
+    computePhi( rho, phi, beta, pc.self_fields_required_precision, pc.getSpeciesId() );
 
     // Compute the corresponding electric and magnetic field, from the potential phi
     computeE( Efield_fp, phi, beta );
@@ -89,46 +87,50 @@ WarpX::AddSpaceChargeField (WarpXParticleContainer& pc)
    \param[in] rho The charge density a given species
    \param[out] phi The potential to be computed by this function
    \param[in] beta Represents the velocity of the source of `phi`
+   \param[in] required_precision Relative tolerance of the solver
+   \param[in] source_id Identifies the source of `rho` (e.g. the species): the
+               last potential of the same source is the initial guess of the solver
 */
 void
 WarpX::computePhi (const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& rho,
                    amrex::Vector<std::unique_ptr<amrex::MultiFab> >& phi,
                    std::array<Real, 3> const beta,
-                   Real const required_precision) const
+                   Real const required_precision,
+                   int const source_id)
 {
-    // Define the boundary conditions
-    Array<LinOpBCType,AMREX_SPACEDIM> lobc, hibc;
-    for (int idim=0; idim<AMREX_SPACEDIM; idim++){
-        if ( Geom(0).isPeriodic(idim) ) {
-            lobc[idim] = LinOpBCType::Periodic;
-            hibc[idim] = LinOpBCType::Periodic;
-        } else {
-            // Use Dirichlet boundary condition by default.
-            // Ideally, we would often want open boundary conditions here.
-            lobc[idim] = LinOpBCType::Dirichlet;
-            hibc[idim] = LinOpBCType::Dirichlet;
+    if (!m_poisson_solver) {
+        // Define the boundary conditions
+        Array<LinOpBCType,AMREX_SPACEDIM> lobc, hibc;
+        for (int idim=0; idim<AMREX_SPACEDIM; idim++){
+            if ( Geom(0).isPeriodic(idim) ) {
+                lobc[idim] = LinOpBCType::Periodic;
+                hibc[idim] = LinOpBCType::Periodic;
+            } else {
+                // Use Dirichlet boundary condition by default.
+                // Ideally, we would often want open boundary conditions here.
+                lobc[idim] = LinOpBCType::Dirichlet;
+                hibc[idim] = LinOpBCType::Dirichlet;
+            }
         }
-    }
 
-    // Define the linear operator (Poisson operator)
-    MLNodeTensorLaplacian linop( Geom(), boxArray(), DistributionMap() );
-    linop.setDomainBC( lobc, hibc );
-    // Set the value of beta
-    amrex::Array<amrex::Real,AMREX_SPACEDIM> beta_solver =
-#if (AMREX_SPACEDIM==2)
-        {{ beta[0], beta[2] }};  // beta_x and beta_z
-#else
-        {{ beta[0], beta[1], beta[2] }};
-#endif
-    linop.setBeta( beta_solver );
+        // Define the linear operator (Poisson operator) and its multigrid
+        // hierarchy, kept until the grids change
+        const int num_levels = finest_level + 1;
+        m_poisson_solver.reset(new PoissonSolver(
+            Vector<Geometry>(Geom().begin(), Geom().begin()+num_levels),
+            Vector<BoxArray>(boxArray().begin(), boxArray().begin()+num_levels),
+            Vector<DistributionMapping>(DistributionMap().begin(), DistributionMap().begin()+num_levels),
+            lobc, hibc));
+        m_poisson_solver_stats.num_setups += 1;
+    }
 
-    // Solve the Poisson equation
-    MLMG mlmg(linop);
-    mlmg.setVerbose(2);
-    mlmg.solve( GetVecOfPtrs(phi), GetVecOfConstPtrs(rho), required_precision, 0.0);
+    // Solve the Poisson equation, starting from the last potential of this source
+    const auto solution = m_poisson_solver->Solve(
+        rho, beta, required_precision, source_id, m_poisson_solver_stats);
 
     // Normalize by the correct physical constant
     for (int lev=0; lev < rho.size(); lev++){
+        MultiFab::Copy(*phi[lev], *solution[lev], 0, 0, 1, phi[lev]->nGrow());
         phi[lev]->mult(-1./PhysConst::ep0);
     }
 }
@@ -153,7 +155,7 @@ WarpX::computeE (amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >
                  const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& phi,
                  std::array<amrex::Real, 3> const beta ) const
 {
-    for (int lev = 0; lev <= max_level; lev++) {
+    for (int lev = 0; lev <= finest_level; lev++) {
 
         const Real* dx = Geom(lev).CellSize();
 
@@ -251,7 +253,7 @@ WarpX::computeB (amrex::Vector<std::array<std::unique_ptr<amrex::MultiFab>, 3> >
                  const amrex::Vector<std::unique_ptr<amrex::MultiFab> >& phi,
                  std::array<amrex::Real, 3> const beta ) const
 {
-    for (int lev = 0; lev <= max_level; lev++) {
+    for (int lev = 0; lev <= finest_level; lev++) {
 
         const Real* dx = Geom(lev).CellSize();
 
@@ -24,27 +24,28 @@ using namespace amrex;
 void FiniteDifferenceSolver::EvolveB (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
 
-        EvolveBCylindrical <CylindricalYeeAlgorithm> ( Bfield, Efield, dt );
+        EvolveBCylindrical <CylindricalYeeAlgorithm> ( Bfield, Efield, dt, cost );
 
 #else
     if (m_do_nodal) {
 
-        EvolveBCartesian <CartesianNodalAlgorithm> ( Bfield, Efield, dt );
+        EvolveBCartesian <CartesianNodalAlgorithm> ( Bfield, Efield, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveBCartesian <CartesianYeeAlgorithm> ( Bfield, Efield, dt );
+        EvolveBCartesian <CartesianYeeAlgorithm> ( Bfield, Efield, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveBCartesian <CartesianCKCAlgorithm> ( Bfield, Efield, dt );
+        EvolveBCartesian <CartesianCKCAlgorithm> ( Bfield, Efield, dt, cost );
 
 #endif
     } else {
@@ -60,7 +61,8 @@ template<typename T_Algo>
 void FiniteDifferenceSolver::EvolveBCartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef _OPENMP
@@ -68,6 +70,8 @@ void FiniteDifferenceSolver::EvolveBCartesian (
 #endif
     for ( MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
         Array4<Real> const& By = Bfield[1]->array(mfi);
@@ -109,6 +113,8 @@ void FiniteDifferenceSolver::EvolveBCartesian (
 
         );
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     }
 
 }
@@ -119,7 +125,8 @@ template<typename T_Algo>
 void FiniteDifferenceSolver::EvolveBCylindrical (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef _OPENMP
@@ -127,6 +134,8 @@ void FiniteDifferenceSolver::EvolveBCylindrical (
 #endif
     for ( MFIter mfi(*Bfield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> const& Br = Bfield[0]->array(mfi);
         Array4<Real> const& Bt = Bfield[1]->array(mfi);
@@ -214,6 +223,8 @@ void FiniteDifferenceSolver::EvolveBCylindrical (
 
         );
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     }
 
 }
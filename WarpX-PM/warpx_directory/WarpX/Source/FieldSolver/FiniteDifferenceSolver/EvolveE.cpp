@@ -28,27 +28,28 @@ void FiniteDifferenceSolver::EvolveE (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
 
-        EvolveECylindrical <CylindricalYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt );
+        EvolveECylindrical <CylindricalYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt, cost );
 
 #else
     if (m_do_nodal) {
 
-        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt );
+        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt );
+        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt );
+        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, Ffield, dt, cost );
 
 #endif
     } else {
@@ -66,7 +67,8 @@ void FiniteDifferenceSolver::EvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     Real constexpr c2 = PhysConst::c * PhysConst::c;
 
@@ -76,6 +78,8 @@ void FiniteDifferenceSolver::EvolveECartesian (
 #endif
     for ( MFIter mfi(*Efield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> const& Ex = Efield[0]->array(mfi);
         Array4<Real> const& Ey = Efield[1]->array(mfi);
@@ -150,6 +154,8 @@ void FiniteDifferenceSolver::EvolveECartesian (
 
         }
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     }
 
 }
@@ -162,7 +168,8 @@ void FiniteDifferenceSolver::EvolveECylindrical (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Bfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef _OPENMP
@@ -170,6 +177,8 @@ void FiniteDifferenceSolver::EvolveECylindrical (
 #endif
     for ( MFIter mfi(*Efield[0], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> const& Er = Efield[0]->array(mfi);
         Array4<Real> const& Et = Efield[1]->array(mfi);
@@ -339,6 +348,8 @@ void FiniteDifferenceSolver::EvolveECylindrical (
 
         } // end of if condition for F
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     } // end of loop over grid/tiles
 
 }
@@ -28,27 +28,28 @@ void FiniteDifferenceSolver::EvolveF (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
     std::unique_ptr<amrex::MultiFab> const& rhofield,
     int const rhocomp,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
 
-        EvolveFCylindrical <CylindricalYeeAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt );
+        EvolveFCylindrical <CylindricalYeeAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt, cost );
 
 #else
     if (m_do_nodal) {
 
-        EvolveFCartesian <CartesianNodalAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt );
+        EvolveFCartesian <CartesianNodalAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveFCartesian <CartesianYeeAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt );
+        EvolveFCartesian <CartesianYeeAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt, cost );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveFCartesian <CartesianCKCAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt );
+        EvolveFCartesian <CartesianCKCAlgorithm> ( Ffield, Efield, rhofield, rhocomp, dt, cost );
 
 #endif
     } else {
@@ -66,7 +67,8 @@ void FiniteDifferenceSolver::EvolveFCartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
     std::unique_ptr<amrex::MultiFab> const& rhofield,
     int const rhocomp,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     Real constexpr c2 = PhysConst::c * PhysConst::c;
 
@@ -76,6 +78,8 @@ void FiniteDifferenceSolver::EvolveFCartesian (
 #endif
     for ( MFIter mfi(*Ffield, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> const& F = Ffield->array(mfi);
         Array4<Real> const& Ex = Efield[0]->array(mfi);
@@ -109,6 +113,8 @@ void FiniteDifferenceSolver::EvolveFCartesian (
 
         );
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     }
 
 }
@@ -121,7 +127,8 @@ void FiniteDifferenceSolver::EvolveFCylindrical (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Efield,
     std::unique_ptr<amrex::MultiFab> const& rhofield,
     int const rhocomp,
-    amrex::Real const dt ) {
+    amrex::Real const dt,
+    CostLedger* const cost ) {
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef _OPENMP
@@ -129,6 +136,8 @@ void FiniteDifferenceSolver::EvolveFCylindrical (
 #endif
     for ( MFIter mfi(*Ffield, TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
 
+        CostTimer cost_timer(cost, mfi.index());
+
         // Extract field data for this grid/tile
         Array4<Real> F = Ffield->array(mfi);
         Array4<Real> const& Er = Efield[0]->array(mfi);
@@ -200,6 +209,8 @@ void FiniteDifferenceSolver::EvolveFCylindrical (
 
         ); // end of loop over cells
 
+        cost_timer.Charge(CostKernel::FieldSolve);
+
     } // end of loop over grid/tiles
 
 }
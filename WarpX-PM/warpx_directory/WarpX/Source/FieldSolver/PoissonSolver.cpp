@@ -0,0 +1,63 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "PoissonSolver.H"
+
+using namespace amrex;
+
+PoissonSolver::PoissonSolver (const Vector<Geometry>& geom,
+                              const Vector<BoxArray>& grids,
+                              const Vector<DistributionMapping>& dmap,
+                              const Array<LinOpBCType,AMREX_SPACEDIM>& lobc,
+                              const Array<LinOpBCType,AMREX_SPACEDIM>& hibc)
+    : m_linop(geom, grids, dmap)
+{
+    m_linop.setDomainBC(lobc, hibc);
+    m_mlmg.reset(new MLMG(m_linop));
+    // The tolerance is relative to the right-hand side, even when the
+    // initial guess is worse than zero
+    m_mlmg->setAlwaysUseBNorm(true);
+}
+
+Vector<MultiFab*>
+PoissonSolver::Solve (const Vector<std::unique_ptr<MultiFab> >& rho,
+                      std::array<Real, 3> const beta,
+                      Real const required_precision,
+                      int const source_id,
+                      PoissonSolverStats& stats)
+{
+    auto& phi = m_solutions[source_id];
+    if (phi.empty()) {
+        phi.resize(rho.size());
+        for (int lev = 0; lev < rho.size(); lev++) {
+            phi[lev].reset(new MultiFab(rho[lev]->boxArray(), rho[lev]->DistributionMap(), 1, 1));
+            phi[lev]->setVal(0.);
+        }
+    } else if (source_id < 0) {
+        for (auto& phi_lev : phi) phi_lev->setVal(0.);
+    }
+
+    // Only the tensor coefficients depend on beta
+    Array<Real,AMREX_SPACEDIM> beta_solver =
+#if (AMREX_SPACEDIM==2)
+        {{ beta[0], beta[2] }};  // beta_x and beta_z
+#else
+        {{ beta[0], beta[1], beta[2] }};
+#endif
+    m_linop.setBeta( beta_solver );
+
+    m_mlmg->solve( GetVecOfPtrs(phi), GetVecOfConstPtrs(rho), required_precision, 0.0);
+
+    const Real rhs_norm = m_mlmg->getInitRHS();
+    stats.num_solves += 1;
+    stats.num_iterations += m_mlmg->getNumIters();
+    stats.last_iterations = m_mlmg->getNumIters();
+    stats.last_initial_residual = rhs_norm > 0. ? m_mlmg->getInitResidual()/rhs_norm : 0.;
+    stats.last_final_residual = rhs_norm > 0. ? m_mlmg->getFinalResidual()/rhs_norm : 0.;
+
+    return GetVecOfPtrs(phi);
+}
@@ -17,7 +17,8 @@ GalileanAlgorithm::GalileanAlgorithm(const SpectralKSpace& spectral_kspace,
                          const Real dt)
      // Initialize members of base class
      : SpectralBaseAlgorithm( spectral_kspace, dm,
-                              norder_x, norder_y, norder_z, nodal )
+                              norder_x, norder_y, norder_z, nodal ),
+       m_v_galilean(v_galilean), m_dt(dt)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
 
@@ -37,10 +38,12 @@ GalileanAlgorithm::GalileanAlgorithm(const SpectralKSpace& spectral_kspace,
 /* Advance the E and B field in spectral space (stored in `f`)
  * over one time step */
 void
-GalileanAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
+GalileanAlgorithm::pushSpectralFields(SpectralFieldData& f,
+                                      CostLedger* const cost) const{
 
     // Loop over boxes
     for (MFIter mfi(f.fields); mfi.isValid(); ++mfi){
+        CostTimer cost_timer(cost, mfi.index());
 
         const Box& bx = f.fields[mfi].box();
 
@@ -122,6 +125,7 @@ GalileanAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
                         - T2*S_ck*I*(kx*Ey_old - ky*Ex_old)
                         +      X1*I*(kx*Jy     - ky*Jx);
         });
+        cost_timer.Charge(CostKernel::FieldSolve);
     }
 };
 
@@ -129,7 +133,8 @@ GalileanAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
 void GalileanAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spectral_kspace,
                                     const amrex::DistributionMapping& dm,
                                     const Array<Real, 3>& v_galilean,
-                                    const amrex::Real dt)
+                                    const amrex::Real dt,
+                                    const amrex::LayoutData<int>* boxes)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
     // Fill them with the right values:
@@ -137,6 +142,8 @@ void GalileanAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spe
     // for each box owned by the local MPI proc
     for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi){
 
+        if (boxes && !(*boxes)[mfi]) continue;
+
         const Box& bx = ba[mfi];
 
         // Extract pointers for the k vectors
@@ -241,4 +248,21 @@ void GalileanAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spe
         });
     }
 }
+
+/* \brief Redistribute the boxes: the coefficients of the boxes that stay
+ * on this process are kept, and only the new boxes are initialized */
+void
+GalileanAlgorithm::Remake(const SpectralKSpace& spectral_kspace,
+                          const amrex::DistributionMapping& dm)
+{
+    RemakeModifiedKVectors(spectral_kspace, dm);
+    RemakeKeepingLocalFabs(C_coef, dm);
+    RemakeKeepingLocalFabs(S_ck_coef, dm);
+    RemakeKeepingLocalFabs(X1_coef, dm);
+    RemakeKeepingLocalFabs(X2_coef, dm);
+    RemakeKeepingLocalFabs(X3_coef, dm);
+    RemakeKeepingLocalFabs(X4_coef, dm);
+    const amrex::LayoutData<int> new_boxes = RemakeKeepingLocalFabs(Theta2_coef, dm);
+    InitializeSpectralCoefficients(spectral_kspace, dm, m_v_galilean, m_dt, &new_boxes);
+}
 #endif // WARPX_USE_PSATD
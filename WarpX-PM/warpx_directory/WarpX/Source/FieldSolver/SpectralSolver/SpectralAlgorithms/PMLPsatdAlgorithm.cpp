@@ -22,7 +22,8 @@ PMLPsatdAlgorithm::PMLPsatdAlgorithm(
                          const int norder_z, const bool nodal, const Real dt)
      // Initialize members of base class
      : SpectralBaseAlgorithm( spectral_kspace, dm,
-                              norder_x, norder_y, norder_z, nodal )
+                              norder_x, norder_y, norder_z, nodal ),
+       m_dt(dt)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
 
@@ -36,10 +37,12 @@ PMLPsatdAlgorithm::PMLPsatdAlgorithm(
 /* Advance the E and B field in spectral space (stored in `f`)
  * over one time step */
 void
-PMLPsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
+PMLPsatdAlgorithm::pushSpectralFields(SpectralFieldData& f,
+                                      CostLedger* const cost) const{
 
     // Loop over boxes
     for (MFIter mfi(f.fields); mfi.isValid(); ++mfi){
+        CostTimer cost_timer(cost, mfi.index());
 
         const Box& bx = f.fields[mfi].box();
 
@@ -102,13 +105,15 @@ PMLPsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
             fields(i,j,k,Idx::Bzx) = C*fields(i,j,k,Idx::Bzx) - S_ck*I*kx*Ey_old;
             fields(i,j,k,Idx::Bzy) = C*fields(i,j,k,Idx::Bzy) + S_ck*I*ky*Ex_old;
         });
+        cost_timer.Charge(CostKernel::FieldSolve);
     }
 };
 
 void PMLPsatdAlgorithm::InitializeSpectralCoefficients (
     const SpectralKSpace& spectral_kspace,
     const amrex::DistributionMapping& dm,
-    const amrex::Real dt)
+    const amrex::Real dt,
+    const amrex::LayoutData<int>* boxes)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
     // Fill them with the right values:
@@ -116,6 +121,8 @@ void PMLPsatdAlgorithm::InitializeSpectralCoefficients (
     // for each box owned by the local MPI proc
     for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi){
 
+        if (boxes && !(*boxes)[mfi]) continue;
+
         const Box& bx = ba[mfi];
 
         // Extract pointers for the k vectors
@@ -154,4 +161,16 @@ void PMLPsatdAlgorithm::InitializeSpectralCoefficients (
         });
     }
 };
+
+/* \brief Redistribute the boxes: the coefficients of the boxes that stay
+ * on this process are kept, and only the new boxes are initialized */
+void
+PMLPsatdAlgorithm::Remake(const SpectralKSpace& spectral_kspace,
+                          const amrex::DistributionMapping& dm)
+{
+    RemakeModifiedKVectors(spectral_kspace, dm);
+    RemakeKeepingLocalFabs(C_coef, dm);
+    const amrex::LayoutData<int> new_boxes = RemakeKeepingLocalFabs(S_ck_coef, dm);
+    InitializeSpectralCoefficients(spectral_kspace, dm, m_dt, &new_boxes);
+}
 #endif // WARPX_USE_PSATD
@@ -20,7 +20,8 @@ PsatdAlgorithm::PsatdAlgorithm(const SpectralKSpace& spectral_kspace,
                          const int norder_z, const bool nodal, const Real dt)
      // Initialize members of base class
      : SpectralBaseAlgorithm( spectral_kspace, dm,
-                              norder_x, norder_y, norder_z, nodal )
+                              norder_x, norder_y, norder_z, nodal ),
+       m_dt(dt)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
 
@@ -37,10 +38,12 @@ PsatdAlgorithm::PsatdAlgorithm(const SpectralKSpace& spectral_kspace,
 /* Advance the E and B field in spectral space (stored in `f`)
  * over one time step */
 void
-PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
+PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f,
+                                   CostLedger* const cost) const{
 
     // Loop over boxes
     for (MFIter mfi(f.fields); mfi.isValid(); ++mfi){
+        CostTimer cost_timer(cost, mfi.index());
 
         const Box& bx = f.fields[mfi].box();
 
@@ -117,12 +120,14 @@ PsatdAlgorithm::pushSpectralFields(SpectralFieldData& f) const{
                         - S_ck*I*(kx*Ey_old - ky*Ex_old)
                         +   X1*I*(kx*Jy     - ky*Jx);
         });
+        cost_timer.Charge(CostKernel::FieldSolve);
     }
 };
 
 void PsatdAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spectral_kspace,
                                     const amrex::DistributionMapping& dm,
-                                    const amrex::Real dt)
+                                    const amrex::Real dt,
+                                    const amrex::LayoutData<int>* boxes)
 {
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
     // Fill them with the right values:
@@ -130,6 +135,8 @@ void PsatdAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spectr
     // for each box owned by the local MPI proc
     for (MFIter mfi(ba, dm); mfi.isValid(); ++mfi){
 
+        if (boxes && !(*boxes)[mfi]) continue;
+
         const Box& bx = ba[mfi];
 
         // Extract pointers for the k vectors
@@ -179,4 +186,19 @@ void PsatdAlgorithm::InitializeSpectralCoefficients(const SpectralKSpace& spectr
         });
      }
 }
+
+/* \brief Redistribute the boxes: the coefficients of the boxes that stay
+ * on this process are kept, and only the new boxes are initialized */
+void
+PsatdAlgorithm::Remake(const SpectralKSpace& spectral_kspace,
+                       const amrex::DistributionMapping& dm)
+{
+    RemakeModifiedKVectors(spectral_kspace, dm);
+    RemakeKeepingLocalFabs(C_coef, dm);
+    RemakeKeepingLocalFabs(S_ck_coef, dm);
+    RemakeKeepingLocalFabs(X1_coef, dm);
+    RemakeKeepingLocalFabs(X2_coef, dm);
+    const amrex::LayoutData<int> new_boxes = RemakeKeepingLocalFabs(X3_coef, dm);
+    InitializeSpectralCoefficients(spectral_kspace, dm, m_dt, &new_boxes);
+}
 #endif // WARPX_USE_PSATD
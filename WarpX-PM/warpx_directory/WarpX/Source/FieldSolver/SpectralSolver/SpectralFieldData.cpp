@@ -49,6 +49,58 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
     // By default, we assume the FFT is done from/to a nodal grid in real space
     // It the FFT is performed from/to a cell-centered grid in real space,
     // a correcting "shift" factor must be applied in spectral space.
+    InitializeShiftFactors(k_space, dm);
+
+    // Allocate and initialize the FFT plans
+    forward_plan = FFTplans(spectralspace_ba, dm);
+    backward_plan = FFTplans(spectralspace_ba, dm);
+    // Loop over boxes and allocate the corresponding plan
+    // for each box owned by the local MPI proc
+    for ( MFIter mfi(spectralspace_ba, dm); mfi.isValid(); ++mfi ){
+        InitializePlans(mfi);
+    }
+}
+
+/* \brief Redistribute the boxes, keeping the arrays and FFT plans of the
+ * boxes that stay on this process */
+void
+SpectralFieldData::Remake( const SpectralKSpace& k_space,
+                           const DistributionMapping& dm )
+{
+    const int myproc = ParallelDescriptor::MyProc();
+
+    // Destroy the plans of the boxes that leave this process
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+        if (dm[mfi.index()] != myproc) DestroyPlans(mfi);
+    }
+    const FFTplans old_forward_plan = forward_plan;
+    const FFTplans old_backward_plan = backward_plan;
+
+    // The FABs of the boxes that stay on this process are moved, and keep
+    // their address: their plans, which refer to tmpRealField and
+    // tmpSpectralField, remain valid
+    RemakeKeepingLocalFabs(fields, dm);
+    RemakeKeepingLocalFabs(tmpSpectralField, dm);
+    const LayoutData<int> is_new = RemakeKeepingLocalFabs(tmpRealField, dm);
+
+    InitializeShiftFactors(k_space, dm);
+
+    forward_plan = FFTplans(k_space.spectralspace_ba, dm);
+    backward_plan = FFTplans(k_space.spectralspace_ba, dm);
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+        if (is_new[mfi]) {
+            InitializePlans(mfi);
+        } else {
+            forward_plan[mfi] = old_forward_plan[mfi.index()];
+            backward_plan[mfi] = old_backward_plan[mfi.index()];
+        }
+    }
+}
+
+void
+SpectralFieldData::InitializeShiftFactors( const SpectralKSpace& k_space,
+                                           const DistributionMapping& dm )
+{
     xshift_FFTfromCell = k_space.getSpectralShiftFactor(dm, 0,
                                     ShiftType::TransformFromCellCentered);
     xshift_FFTtoCell = k_space.getSpectralShiftFactor(dm, 0,
@@ -68,131 +120,136 @@ SpectralFieldData::SpectralFieldData( const amrex::BoxArray& realspace_ba,
     zshift_FFTtoCell = k_space.getSpectralShiftFactor(dm, 1,
                                     ShiftType::TransformToCellCentered);
 #endif
+}
 
-    // Allocate and initialize the FFT plans
-    forward_plan = FFTplans(spectralspace_ba, dm);
-    backward_plan = FFTplans(spectralspace_ba, dm);
-    // Loop over boxes and allocate the corresponding plan
-    // for each box owned by the local MPI proc
-    for ( MFIter mfi(spectralspace_ba, dm); mfi.isValid(); ++mfi ){
-        // Note: the size of the real-space box and spectral-space box
-        // differ when using real-to-complex FFT. When initializing
-        // the FFT plan, the valid dimensions are those of the real-space box.
-        IntVect fft_size = realspace_ba[mfi].length();
+/* \brief Create the FFT plans of the box `mfi`, from `tmpRealField`
+ * to `tmpSpectralField` and back */
+void
+SpectralFieldData::InitializePlans( const MFIter& mfi )
+{
+    // Note: the size of the real-space box and spectral-space box
+    // differ when using real-to-complex FFT. When initializing
+    // the FFT plan, the valid dimensions are those of the real-space box.
+    IntVect fft_size = tmpRealField[mfi].box().length();
 #ifdef AMREX_USE_GPU
-        // Create cuFFT plans
-        // Creating 3D plan for real to complex -- double precision
-        // Assuming CUDA is used for programming GPU
-        // Note that D2Z is inherently forward plan
-        // and  Z2D is inherently backward plan
-        cufftResult result;
+    // Create cuFFT plans
+    // Creating 3D plan for real to complex -- double precision
+    // Assuming CUDA is used for programming GPU
+    // Note that D2Z is inherently forward plan
+    // and  Z2D is inherently backward plan
+    cufftResult result;
 #  if (AMREX_SPACEDIM == 3)
-        result = cufftPlan3d( &forward_plan[mfi], fft_size[2], fft_size[1],fft_size[0],
+    result = cufftPlan3d( &forward_plan[mfi], fft_size[2], fft_size[1],fft_size[0],
 #    ifdef AMREX_USE_FLOAT
-                              CUFFT_R2C);
+                          CUFFT_R2C);
 #    else
-                              CUFFT_D2Z);
+                          CUFFT_D2Z);
 #    endif
-        if ( result != CUFFT_SUCCESS ) {
-            amrex::Print() << " cufftplan3d forward failed! Error: " <<
-            cufftErrorToString(result) << "\n";
-        }
+    if ( result != CUFFT_SUCCESS ) {
+        amrex::Print() << " cufftplan3d forward failed! Error: " <<
+        cufftErrorToString(result) << "\n";
+    }
 
-        result = cufftPlan3d( &backward_plan[mfi], fft_size[2], fft_size[1],fft_size[0],
+    result = cufftPlan3d( &backward_plan[mfi], fft_size[2], fft_size[1],fft_size[0],
 #    ifdef AMREX_USE_FLOAT
-                              CUFFT_C2R);
+                          CUFFT_C2R);
 #    else
-                              CUFFT_Z2D);
+                          CUFFT_Z2D);
 #    endif
-        if ( result != CUFFT_SUCCESS ) {
-           amrex::Print() << " cufftplan3d backward failed! Error: " <<
-            cufftErrorToString(result) << "\n";
-        }
+    if ( result != CUFFT_SUCCESS ) {
+       amrex::Print() << " cufftplan3d backward failed! Error: " <<
+        cufftErrorToString(result) << "\n";
+    }
 #  else
-        result = cufftPlan2d( &forward_plan[mfi], fft_size[1], fft_size[0],
+    result = cufftPlan2d( &forward_plan[mfi], fft_size[1], fft_size[0],
 #    ifdef AMREX_USE_FLOAT
-                              CUFFT_R2C);
+                          CUFFT_R2C);
 #    else
-                              CUFFT_D2Z);
+                          CUFFT_D2Z);
 #    endif
-        if ( result != CUFFT_SUCCESS ) {
-           amrex::Print() << " cufftplan2d forward failed! Error: " <<
-            cufftErrorToString(result) << "\n";
-        }
+    if ( result != CUFFT_SUCCESS ) {
+       amrex::Print() << " cufftplan2d forward failed! Error: " <<
+        cufftErrorToString(result) << "\n";
+    }
 
-        result = cufftPlan2d( &backward_plan[mfi], fft_size[1], fft_size[0],
+    result = cufftPlan2d( &backward_plan[mfi], fft_size[1], fft_size[0],
 #    ifdef AMREX_USE_FLOAT
-                              CUFFT_C2R);
+                          CUFFT_C2R);
 #    else
-                              CUFFT_Z2D);
+                          CUFFT_Z2D);
 #    endif
-        if ( result != CUFFT_SUCCESS ) {
-           amrex::Print() << " cufftplan2d backward failed! Error: " <<
-            cufftErrorToString(result) << "\n";
-        }
+    if ( result != CUFFT_SUCCESS ) {
+       amrex::Print() << " cufftplan2d backward failed! Error: " <<
+        cufftErrorToString(result) << "\n";
+    }
 #  endif
 
 #else
-        // Create FFTW plans
-        forward_plan[mfi] =
-            // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
+    // Create FFTW plans
+    forward_plan[mfi] =
+        // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
 #  if (AMREX_SPACEDIM == 3)
 #    ifdef AMREX_USE_FLOAT
-            fftwf_plan_dft_r2c_3d( fft_size[2], fft_size[1], fft_size[0],
+        fftwf_plan_dft_r2c_3d( fft_size[2], fft_size[1], fft_size[0],
 #    else
-            fftw_plan_dft_r2c_3d( fft_size[2], fft_size[1], fft_size[0],
+        fftw_plan_dft_r2c_3d( fft_size[2], fft_size[1], fft_size[0],
 #    endif
 #  else
 #    ifdef AMREX_USE_FLOAT
-            fftwf_plan_dft_r2c_2d( fft_size[1], fft_size[0],
+        fftwf_plan_dft_r2c_2d( fft_size[1], fft_size[0],
 #    else
-            fftw_plan_dft_r2c_2d( fft_size[1], fft_size[0],
+        fftw_plan_dft_r2c_2d( fft_size[1], fft_size[0],
 #    endif
 #  endif
-            tmpRealField[mfi].dataPtr(),
-            reinterpret_cast<fftw_precision_complex*>( tmpSpectralField[mfi].dataPtr() ),
-            FFTW_ESTIMATE );
-        backward_plan[mfi] =
-            // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
+        tmpRealField[mfi].dataPtr(),
+        reinterpret_cast<fftw_precision_complex*>( tmpSpectralField[mfi].dataPtr() ),
+        FFTW_ESTIMATE );
+    backward_plan[mfi] =
+        // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
 #  if (AMREX_SPACEDIM == 3)
 #    ifdef AMREX_USE_FLOAT
-            fftwf_plan_dft_c2r_3d( fft_size[2], fft_size[1], fft_size[0],
+        fftwf_plan_dft_c2r_3d( fft_size[2], fft_size[1], fft_size[0],
 #    else
-            fftw_plan_dft_c2r_3d( fft_size[2], fft_size[1], fft_size[0],
+        fftw_plan_dft_c2r_3d( fft_size[2], fft_size[1], fft_size[0],
 #    endif
 #  else
 #    ifdef AMREX_USE_FLOAT
-            fftwf_plan_dft_c2r_2d( fft_size[1], fft_size[0],
+        fftwf_plan_dft_c2r_2d( fft_size[1], fft_size[0],
 #    else
-            fftw_plan_dft_c2r_2d( fft_size[1], fft_size[0],
+        fftw_plan_dft_c2r_2d( fft_size[1], fft_size[0],
 #    endif
 #  endif
-            reinterpret_cast<fftw_precision_complex*>( tmpSpectralField[mfi].dataPtr() ),
-            tmpRealField[mfi].dataPtr(),
-            FFTW_ESTIMATE );
+        reinterpret_cast<fftw_precision_complex*>( tmpSpectralField[mfi].dataPtr() ),
+        tmpRealField[mfi].dataPtr(),
+        FFTW_ESTIMATE );
 #endif
-    }
 }
 
-
-SpectralFieldData::~SpectralFieldData()
+void
+SpectralFieldData::DestroyPlans( const MFIter& mfi )
 {
-    if (tmpRealField.size() > 0){
-        for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
 #ifdef AMREX_USE_GPU
-            // Destroy cuFFT plans
-            cufftDestroy( forward_plan[mfi] );
-            cufftDestroy( backward_plan[mfi] );
+    // Destroy cuFFT plans
+    cufftDestroy( forward_plan[mfi] );
+    cufftDestroy( backward_plan[mfi] );
 #else
-            // Destroy FFTW plans
+    // Destroy FFTW plans
 #  ifdef AMREX_USE_FLOAT
-            fftwf_destroy_plan( forward_plan[mfi] );
-            fftwf_destroy_plan( backward_plan[mfi] );
+    fftwf_destroy_plan( forward_plan[mfi] );
+    fftwf_destroy_plan( backward_plan[mfi] );
 #  else
-            fftw_destroy_plan( forward_plan[mfi] );
-            fftw_destroy_plan( backward_plan[mfi] );
+    fftw_destroy_plan( forward_plan[mfi] );
+    fftw_destroy_plan( backward_plan[mfi] );
 #  endif
 #endif
+}
+
+
+SpectralFieldData::~SpectralFieldData()
+{
+    if (tmpRealField.size() > 0){
+        for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
+            DestroyPlans(mfi);
         }
     }
 }
@@ -203,7 +260,8 @@ SpectralFieldData::~SpectralFieldData()
 void
 SpectralFieldData::ForwardTransform( const MultiFab& mf,
                                      const int field_index,
-                                     const int i_comp )
+                                     const int i_comp,
+                                     CostLedger* const cost )
 {
     // Check field index type, in order to apply proper shift in spectral space
     const bool is_nodal_x = mf.is_nodal(0);
@@ -216,6 +274,7 @@ SpectralFieldData::ForwardTransform( const MultiFab& mf,
 
     // Loop over boxes
     for ( MFIter mfi(mf); mfi.isValid(); ++mfi ){
+        CostTimer cost_timer(cost, mfi.index());
 
         // Copy the real-space field `mf` to the temporary field `tmpRealField`
         // This ensures that all fields have the same number of points
@@ -294,6 +353,7 @@ SpectralFieldData::ForwardTransform( const MultiFab& mf,
                 fields_arr(i,j,k,field_index) = spectral_field_value;
             });
         }
+        cost_timer.Charge(CostKernel::FFT);
     }
 }
 
@@ -303,7 +363,8 @@ SpectralFieldData::ForwardTransform( const MultiFab& mf,
 void
 SpectralFieldData::BackwardTransform( MultiFab& mf,
                                       const int field_index,
-                                      const int i_comp )
+                                      const int i_comp,
+                                      CostLedger* const cost )
 {
     // Check field index type, in order to apply proper shift in spectral space
     const bool is_nodal_x = mf.is_nodal(0);
@@ -316,6 +377,7 @@ SpectralFieldData::BackwardTransform( MultiFab& mf,
 
     // Loop over boxes
     for ( MFIter mfi(mf); mfi.isValid(); ++mfi ){
+        CostTimer cost_timer(cost, mfi.index());
 
         // Copy the spectral-space field `tmpSpectralField` to the appropriate
         // field (specified by the input argument field_index)
@@ -395,6 +457,7 @@ SpectralFieldData::BackwardTransform( MultiFab& mf,
                 mf_arr(i,j,k,i_comp) = inv_N*tmp_arr(i,j,k);
             });
         }
+        cost_timer.Charge(CostKernel::FFT);
     }
 }
 
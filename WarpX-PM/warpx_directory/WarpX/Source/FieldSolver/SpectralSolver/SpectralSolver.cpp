@@ -36,7 +36,8 @@ SpectralSolver::SpectralSolver(
                 const int norder_z, const bool nodal,
                 const amrex::Array<amrex::Real,3>& v_galilean,
                 const amrex::RealVect dx, const amrex::Real dt,
-                const bool pml ) {
+                const bool pml )
+    : m_realspace_ba(realspace_ba), m_dx(dx) {
 
     // Initialize all structures using the same distribution mapping dm
 
@@ -68,30 +69,43 @@ SpectralSolver::SpectralSolver(
 
 }
 
+void
+SpectralSolver::Remake( const amrex::DistributionMapping& dm )
+{
+    WARPX_PROFILE("SpectralSolver::Remake");
+    // The k vectors and shift factors are 1D arrays: they are simply
+    // recomputed for the boxes of this process
+    const SpectralKSpace k_space = SpectralKSpace(m_realspace_ba, dm, m_dx);
+    algorithm->Remake( k_space, dm );
+    field_data.Remake( k_space, dm );
+}
+
 void
 SpectralSolver::ForwardTransform( const amrex::MultiFab& mf,
                                   const int field_index,
-                                  const int i_comp )
+                                  const int i_comp,
+                                  CostLedger* const cost )
 {
     WARPX_PROFILE("SpectralSolver::ForwardTransform");
-    field_data.ForwardTransform( mf, field_index, i_comp );
+    field_data.ForwardTransform( mf, field_index, i_comp, cost );
 }
 
 void
 SpectralSolver::BackwardTransform( amrex::MultiFab& mf,
                                    const int field_index,
-                                   const int i_comp )
+                                   const int i_comp,
+                                   CostLedger* const cost )
 {
     WARPX_PROFILE("SpectralSolver::BackwardTransform");
-    field_data.BackwardTransform( mf, field_index, i_comp );
+    field_data.BackwardTransform( mf, field_index, i_comp, cost );
 }
 
 void
-SpectralSolver::pushSpectralFields(){
+SpectralSolver::pushSpectralFields( CostLedger* const cost ){
     WARPX_PROFILE("SpectralSolver::pushSpectralFields");
     // Virtual function: the actual function used here depends
     // on the sub-class of `SpectralBaseAlgorithm` that was
     // initialized in the constructor of `SpectralSolver`
-    algorithm->pushSpectralFields( field_data );
+    algorithm->pushSpectralFields( field_data, cost );
 }
 #endif // WARPX_USE_PSATD
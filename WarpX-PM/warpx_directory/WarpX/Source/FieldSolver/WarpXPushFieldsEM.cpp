@@ -33,31 +33,32 @@ namespace {
         std::array<std::unique_ptr<amrex::MultiFab>,3>& Efield,
         std::array<std::unique_ptr<amrex::MultiFab>,3>& Bfield,
         std::array<std::unique_ptr<amrex::MultiFab>,3>& current,
-        std::unique_ptr<amrex::MultiFab>& rho ) {
+        std::unique_ptr<amrex::MultiFab>& rho,
+        CostLedger* const cost ) {
 
         using Idx = SpectralFieldIndex;
 
         // Perform forward Fourier transform
-        solver.ForwardTransform(*Efield[0], Idx::Ex);
-        solver.ForwardTransform(*Efield[1], Idx::Ey);
-        solver.ForwardTransform(*Efield[2], Idx::Ez);
-        solver.ForwardTransform(*Bfield[0], Idx::Bx);
-        solver.ForwardTransform(*Bfield[1], Idx::By);
-        solver.ForwardTransform(*Bfield[2], Idx::Bz);
-        solver.ForwardTransform(*current[0], Idx::Jx);
-        solver.ForwardTransform(*current[1], Idx::Jy);
-        solver.ForwardTransform(*current[2], Idx::Jz);
-        solver.ForwardTransform(*rho, Idx::rho_old, 0);
-        solver.ForwardTransform(*rho, Idx::rho_new, 1);
+        solver.ForwardTransform(*Efield[0], Idx::Ex, 0, cost);
+        solver.ForwardTransform(*Efield[1], Idx::Ey, 0, cost);
+        solver.ForwardTransform(*Efield[2], Idx::Ez, 0, cost);
+        solver.ForwardTransform(*Bfield[0], Idx::Bx, 0, cost);
+        solver.ForwardTransform(*Bfield[1], Idx::By, 0, cost);
+        solver.ForwardTransform(*Bfield[2], Idx::Bz, 0, cost);
+        solver.ForwardTransform(*current[0], Idx::Jx, 0, cost);
+        solver.ForwardTransform(*current[1], Idx::Jy, 0, cost);
+        solver.ForwardTransform(*current[2], Idx::Jz, 0, cost);
+        solver.ForwardTransform(*rho, Idx::rho_old, 0, cost);
+        solver.ForwardTransform(*rho, Idx::rho_new, 1, cost);
         // Advance fields in spectral space
-        solver.pushSpectralFields();
+        solver.pushSpectralFields(cost);
         // Perform backward Fourier Transform
-        solver.BackwardTransform(*Efield[0], Idx::Ex);
-        solver.BackwardTransform(*Efield[1], Idx::Ey);
-        solver.BackwardTransform(*Efield[2], Idx::Ez);
-        solver.BackwardTransform(*Bfield[0], Idx::Bx);
-        solver.BackwardTransform(*Bfield[1], Idx::By);
-        solver.BackwardTransform(*Bfield[2], Idx::Bz);
+        solver.BackwardTransform(*Efield[0], Idx::Ex, 0, cost);
+        solver.BackwardTransform(*Efield[1], Idx::Ey, 0, cost);
+        solver.BackwardTransform(*Efield[2], Idx::Ez, 0, cost);
+        solver.BackwardTransform(*Bfield[0], Idx::Bx, 0, cost);
+        solver.BackwardTransform(*Bfield[1], Idx::By, 0, cost);
+        solver.BackwardTransform(*Bfield[2], Idx::Bz, 0, cost);
     }
 }
 
@@ -76,7 +77,9 @@ WarpX::PushPSATD (amrex::Real a_dt)
 
         // Evolve the fields in the PML boxes
         if (do_pml && pml[lev]->ok()) {
+            CostTimer pml_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
             pml[lev]->PushPSATD();
+            pml_timer.Charge(CostKernel::PML);
         }
     }
 }
@@ -84,12 +87,14 @@ WarpX::PushPSATD (amrex::Real a_dt)
 void
 WarpX::PushPSATD_localFFT (int lev, amrex::Real /* dt */)
 {
+    CostLedger* cost = WarpX::getCosts(lev);
+
     // Update the fields on the fine and coarse patch
     PushPSATDSinglePatch( *spectral_solver_fp[lev],
-        Efield_fp[lev], Bfield_fp[lev], current_fp[lev], rho_fp[lev] );
+        Efield_fp[lev], Bfield_fp[lev], current_fp[lev], rho_fp[lev], cost );
     if (spectral_solver_cp[lev]) {
         PushPSATDSinglePatch( *spectral_solver_cp[lev],
-             Efield_cp[lev], Bfield_cp[lev], current_cp[lev], rho_cp[lev] );
+             Efield_cp[lev], Bfield_cp[lev], current_cp[lev], rho_cp[lev], cost );
     }
 }
 #endif
@@ -117,10 +122,12 @@ void
 WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt)
 {
 
+    CostLedger* cost = WarpX::getCosts(lev);
+
     if (patch_type == PatchType::fine) {
-        m_fdtd_solver_fp[lev]->EvolveB( Bfield_fp[lev], Efield_fp[lev], a_dt );
+        m_fdtd_solver_fp[lev]->EvolveB( Bfield_fp[lev], Efield_fp[lev], a_dt, cost );
     } else {
-        m_fdtd_solver_cp[lev]->EvolveB( Bfield_cp[lev], Efield_cp[lev], a_dt );
+        m_fdtd_solver_cp[lev]->EvolveB( Bfield_cp[lev], Efield_cp[lev], a_dt, cost );
     }
 
     const int patch_level = (patch_type == PatchType::fine) ? lev : lev-1;
@@ -129,6 +136,8 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt)
 
     if (do_pml && pml[lev]->ok())
     {
+        CostTimer pml_timer(cost, CostTimer::LocalBoxes);
+
         const auto& pml_B = (patch_type == PatchType::fine) ? pml[lev]->GetB_fp() : pml[lev]->GetB_cp();
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
 
@@ -191,6 +200,8 @@ WarpX::EvolveB (int lev, PatchType patch_type, amrex::Real a_dt)
 
             }
         }
+
+        pml_timer.Charge(CostKernel::PML);
     }
 }
 
@@ -218,12 +229,14 @@ void
 WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
 {
 
+    CostLedger* cost = WarpX::getCosts(lev);
+
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->EvolveE( Efield_fp[lev], Bfield_fp[lev],
-                                      current_fp[lev], F_fp[lev], a_dt );
+                                      current_fp[lev], F_fp[lev], a_dt, cost );
     } else {
         m_fdtd_solver_cp[lev]->EvolveE( Efield_cp[lev], Bfield_cp[lev],
-                                      current_cp[lev], F_cp[lev], a_dt );
+                                      current_cp[lev], F_cp[lev], a_dt, cost );
     }
 
     const Real mu_c2_dt = (PhysConst::mu0*PhysConst::c*PhysConst::c) * a_dt;
@@ -262,16 +275,15 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
         F  = F_cp[lev].get();
     }
 
-    MultiFab* cost = WarpX::getCosts(lev);
-    const IntVect& rr = (lev > 0) ? refRatio(lev-1) : IntVect::TheUnitVector();
-
     // xmin is only used by the kernel for cylindrical geometry,
     // in which case it is actually rmin.
     const Real xmin = Geom(0).ProbLo(0);
 
     if (do_pml && pml[lev]->ok())
     {
+        CostTimer pml_timer(cost, CostTimer::LocalBoxes);
         if (F) pml[lev]->ExchangeF(patch_type, F, do_pml_in_domain);
+        pml_timer.Charge(CostKernel::Communication);
 
         const auto& pml_B = (patch_type == PatchType::fine) ? pml[lev]->GetB_fp() : pml[lev]->GetB_cp();
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
@@ -391,6 +403,8 @@ WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
                }
             }
         }
+
+        pml_timer.Charge(CostKernel::PML);
     }
 }
 
@@ -423,12 +437,14 @@ WarpX::EvolveF (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_typ
 
     const int rhocomp = (a_dt_type == DtType::FirstHalf) ? 0 : 1;
 
+    CostLedger* cost = WarpX::getCosts(lev);
+
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->EvolveF( F_fp[lev], Efield_fp[lev],
-                                        rho_fp[lev], rhocomp, a_dt );
+                                        rho_fp[lev], rhocomp, a_dt, cost );
     } else {
         m_fdtd_solver_cp[lev]->EvolveF( F_cp[lev], Efield_cp[lev],
-                                        rho_cp[lev], rhocomp, a_dt );
+                                        rho_cp[lev], rhocomp, a_dt, cost );
     }
 
     const int patch_level = (patch_type == PatchType::fine) ? lev : lev-1;
@@ -437,6 +453,8 @@ WarpX::EvolveF (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_typ
 
     if (do_pml && pml[lev]->ok())
     {
+        CostTimer pml_timer(cost, CostTimer::LocalBoxes);
+
         const auto& pml_F = (patch_type == PatchType::fine) ? pml[lev]->GetF_fp() : pml[lev]->GetF_cp();
         const auto& pml_E = (patch_type == PatchType::fine) ? pml[lev]->GetE_fp() : pml[lev]->GetE_cp();
 
@@ -461,6 +479,8 @@ WarpX::EvolveF (int lev, PatchType patch_type, amrex::Real a_dt, DtType a_dt_typ
             });
 
         }
+
+        pml_timer.Charge(CostKernel::PML);
     }
 }
 
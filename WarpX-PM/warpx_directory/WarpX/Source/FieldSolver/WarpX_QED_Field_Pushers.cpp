@@ -83,8 +83,7 @@ WarpX::Hybrid_QED_Push (int lev, PatchType patch_type, Real a_dt)
         Bz = Bfield_cp[lev][2].get();
     }
 
-    MultiFab* cost = WarpX::getCosts(lev);
-    const IntVect& rr = (lev > 0) ? refRatio(lev-1) : IntVect::TheUnitVector();
+    CostLedger* cost = WarpX::getCosts(lev);
 
     // xmin is only used by the kernel for cylindrical geometry,
     // in which case it is actually rmin.
@@ -96,7 +95,7 @@ WarpX::Hybrid_QED_Push (int lev, PatchType patch_type, Real a_dt)
 #endif
     for ( MFIter mfi(*Bx, TilingIfNotGPU()); mfi.isValid(); ++mfi )
     {
-        Real wt = amrex::second();
+        CostTimer cost_timer(cost, mfi.index());
 
         // Get boxes for E and B
         const Box& tbx  = mfi.tilebox(Bx_nodal_flag);
@@ -162,19 +161,6 @@ WarpX::Hybrid_QED_Push (int lev, PatchType patch_type, Real a_dt)
             }
         );
 
-        if (cost) {
-            Box cbx = mfi.tilebox(IntVect{AMREX_D_DECL(0,0,0)});
-            if (patch_type == PatchType::coarse) cbx.refine(rr);
-            wt = (amrex::second() - wt) / cbx.d_numPts();
-            auto costfab = cost->array(mfi);
-
-            amrex::ParallelFor(
-                cbx,
-                [=] AMREX_GPU_DEVICE (int i, int j, int k)
-                {
-                    costfab(i,j,k) += wt;
-                }
-            );
-        }
+        cost_timer.Charge(CostKernel::FieldSolve);
     }
 }
@@ -38,7 +38,7 @@ Filter::ApplyStencil (MultiFab& dstmf, const MultiFab& srcmf, int scomp, int dco
         const Box& gbx = amrex::grow(tbx,stencil_length_each_dir-1);
 
         // tmpfab has enough ghost cells for the stencil
-        FArrayBox tmp_fab(gbx,ncomp);
+        FArrayBox tmp_fab(gbx,ncomp,WarpX::GetInstance().ScratchPool().TileArena());
         Elixir tmp_eli = tmp_fab.elixir();  // Prevent the tmp data from being deleted too early
         auto const& tmp = tmp_fab.array();
 
@@ -77,7 +77,7 @@ Filter::ApplyStencil (FArrayBox& dstfab, const FArrayBox& srcfab,
     const Box& gbx = amrex::grow(tbx,stencil_length_each_dir-1);
 
     // tmpfab has enough ghost cells for the stencil
-    FArrayBox tmp_fab(gbx,ncomp);
+    FArrayBox tmp_fab(gbx,ncomp,WarpX::GetInstance().ScratchPool().TileArena());
     Elixir tmp_eli = tmp_fab.elixir();  // Prevent the tmp data from being deleted too early
     auto const& tmp = tmp_fab.array();
 
@@ -160,7 +160,7 @@ Filter::ApplyStencil (amrex::MultiFab& dstmf, const amrex::MultiFab& srcmf, int
 #pragma omp parallel
 #endif
     {
-        FArrayBox tmpfab;
+        FArrayBox tmpfab(WarpX::GetInstance().ScratchPool().TileArena());
         for (MFIter mfi(dstmf,true); mfi.isValid(); ++mfi){
             const auto& srcfab = srcmf[mfi];
             auto& dstfab = dstmf[mfi];
@@ -192,7 +192,7 @@ Filter::ApplyStencil (amrex::FArrayBox& dstfab, const amrex::FArrayBox& srcfab,
 {
     WARPX_PROFILE("BilinearFilter::ApplyStencil(FArrayBox)");
     ncomp = std::min(ncomp, srcfab.nComp());
-    FArrayBox tmpfab;
+    FArrayBox tmpfab(WarpX::GetInstance().ScratchPool().TileArena());
     const Box& gbx = amrex::grow(tbx,stencil_length_each_dir-1);
     // tmpfab has enough ghost cells for the stencil
     tmpfab.resize(gbx,ncomp);
@@ -375,9 +375,9 @@ void PlasmaInjector::parseMomentum (ParmParse& pp)
     }
 }
 
-XDim3 PlasmaInjector::getMomentum (Real x, Real y, Real z) const noexcept
+XDim3 PlasmaInjector::getMomentum (Real x, Real y, Real z, RandomEngine& engine) const noexcept
 {
-    return inj_mom->getMomentum(x, y, z); // gamma*beta
+    return inj_mom->getMomentum(x, y, z, engine); // gamma*beta
 }
 
 bool PlasmaInjector::insideBounds (Real x, Real y, Real z) const noexcept
@@ -13,6 +13,7 @@
 #include "Parser/GpuParser.H"
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
+#include "Utils/NodeSharedVector.H"
 
 #include <AMReX_ParallelDescriptor.H>
 #include <AMReX_ParmParse.H>
@@ -62,6 +63,8 @@ WarpX::InitData ()
         printGridSummary(std::cout, 0, finestLevel());
     }
 
+    NodeShared::PrintReport();
+
 #ifdef BL_USE_SENSEI_INSITU
     insitu_bridge = new amrex::AmrMeshInSituBridge;
     insitu_bridge->setEnabled(insitu_int > 0 ? 1 : 0);
@@ -135,6 +138,12 @@ WarpX::InitFromScratch ()
     mypc->AllocData();
     mypc->InitData();
 
+    // The particles were not there when the grids were made: tag again
+    if (max_level > 0 && !refine_density_species.empty()) {
+        AmrCore::regrid(0, time);
+        mypc->Redistribute();
+    }
+
     // Loop through species and calculate their space-charge field
     bool const reset_fields = false; // Do not erase previous user-specified values on the grid
     ComputeSpaceChargeField(reset_fields);
@@ -162,24 +171,29 @@ WarpX::InitPML ()
                              do_pml_Lo_corrected, do_pml_Hi));
         for (int lev = 1; lev <= finest_level; ++lev)
         {
-            amrex::IntVect do_pml_Lo_MR = amrex::IntVect::TheUnitVector();
+            InitPMLPatch(lev, boxArray(lev), DistributionMap(lev));
+        }
+    }
+}
+
+void
+WarpX::InitPMLPatch (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    amrex::IntVect do_pml_Lo_MR = amrex::IntVect::TheUnitVector();
 #ifdef WARPX_DIM_RZ
-            //In cylindrical geometry, if the edge of the patch is at r=0, do not add PML
-            if ((max_level > 0) && (fine_tag_lo[0]==0.)) {
-                do_pml_Lo_MR[0] = 0;
-            }
+    //In cylindrical geometry, if the edge of the patch is at r=0, do not add PML
+    if (ba.minimalBox().smallEnd(0) == Geom(lev).Domain().smallEnd(0)) {
+        do_pml_Lo_MR[0] = 0;
+    }
 #endif
-            pml[lev].reset(new PML(boxArray(lev), DistributionMap(lev),
-                                   &Geom(lev), &Geom(lev-1),
-                                   pml_ncell, pml_delta, refRatio(lev-1)[0],
+    pml[lev].reset(new PML(ba, dm, &Geom(lev), &Geom(lev-1),
+                           pml_ncell, pml_delta, refRatio(lev-1)[0],
 #ifdef WARPX_USE_PSATD
-                                   dt[lev], nox_fft, noy_fft, noz_fft, do_nodal,
+                           dt[lev], nox_fft, noy_fft, noz_fft, do_nodal,
 #endif
-                                   do_dive_cleaning, do_moving_window,
-                                   pml_has_particles, do_pml_in_domain,
-                                   do_pml_Lo_MR, amrex::IntVect::TheUnitVector()));
-        }
-    }
+                           do_dive_cleaning, do_moving_window,
+                           pml_has_particles, do_pml_in_domain,
+                           do_pml_Lo_MR, amrex::IntVect::TheUnitVector()));
 }
 
 void
@@ -416,7 +430,7 @@ WarpX::InitLevelData (int lev, Real /*time*/)
 
     if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers) {
         if (costs[lev]) {
-            costs[lev]->setVal(0.0);
+            costs[lev]->Reset();
         }
     } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic) {
         if (costs_heuristic[lev]) {
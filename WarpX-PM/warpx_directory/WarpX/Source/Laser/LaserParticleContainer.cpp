@@ -407,8 +407,9 @@ LaserParticleContainer::Evolve (int lev,
 
     BL_ASSERT(OnSameGrids(lev,jx));
 
-    MultiFab* cost = WarpX::getCosts(lev);
+    CostLedger* cost = WarpX::getCosts(lev);
 
+    BeginDepositionTileLoop(lev);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -423,7 +424,7 @@ LaserParticleContainer::Evolve (int lev,
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            Real wt = amrex::second();
+            CostTimer cost_timer(cost, pti.index());
 
             auto& attribs = pti.GetAttribs();
 
@@ -448,6 +449,7 @@ LaserParticleContainer::Evolve (int lev,
                     DepositCharge(pti, wp, ion_lev, crho, 0, np_current,
                                   np-np_current, thread_num, lev, lev-1);
                 }
+                cost_timer.Charge(CostKernel::Deposit);
             }
 
             //
@@ -470,6 +472,7 @@ LaserParticleContainer::Evolve (int lev,
                                   uzp.dataPtr(), wp.dataPtr(),
                                   amplitude_E.dataPtr(), dt);
             WARPX_PROFILE_VAR_STOP(blp_pp);
+            cost_timer.Charge(CostKernel::Push);
 
             //
             // Current Deposition
@@ -499,19 +502,10 @@ LaserParticleContainer::Evolve (int lev,
                                   np-np_current, thread_num, lev, lev-1);
                 }
             }
-
-            if (cost) {
-                const Box& tbx = pti.tilebox();
-                wt = (amrex::second() - wt) / tbx.d_numPts();
-                Array4<Real> const& costarr = cost->array(pti);
-                amrex::ParallelFor(tbx,
-                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    costarr(i,j,k) += wt;
-                });
-            }
+            cost_timer.Charge(CostKernel::Deposit);
         }
     }
+    EndDepositionTileLoop();
 }
 
 void
@@ -55,7 +55,7 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::init (
     //Allocate memory for E_data Vector
     const int data_size = m_params.time_chunk_size*
             m_params.nx*m_params.ny;
-    m_params.E_data = Gpu::ManagedVector<amrex::Real>(data_size);
+    m_params.E_data.resize(data_size);
 
     //Read first time chunck
     read_data_t_chuck(0, m_params.time_chunk_size);
@@ -257,6 +257,9 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::read_data_t_chuck(int t_begin, int
     if(i_last-i_first+1 > m_params.E_data.size())
         Abort("Data chunk to read from file is too large");
 
+    //The other processes of the node may still be using the previous chunk
+    m_params.E_data.Fence();
+
     if(ParallelDescriptor::IOProcessor()){
         //Read data chunk
         std::ifstream inp(m_params.txye_file_name, std::ios::binary);
@@ -279,8 +282,7 @@ WarpXLaserProfiles::FromTXYEFileLaserProfile::read_data_t_chuck(int t_begin, int
     }
 
     //Broadcast E_data
-    ParallelDescriptor::Bcast(m_params.E_data.dataPtr(),
-        m_params.E_data.size(), ParallelDescriptor::IOProcessorNumber());
+    m_params.E_data.Bcast(ParallelDescriptor::IOProcessorNumber());
     ParallelDescriptor::Barrier();
 
     //Update first and last indices
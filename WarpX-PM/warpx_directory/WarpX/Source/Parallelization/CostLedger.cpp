@@ -0,0 +1,83 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "CostLedger.H"
+
+#include <AMReX_ParallelDescriptor.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+const char*
+CostKernel::Name (int kernel)
+{
+    switch (kernel)
+    {
+        case Gather: return "gather";
+        case Push: return "push";
+        case Deposit: return "deposit";
+        case FieldSolve: return "fieldsolve";
+        case PML: return "pml";
+        case Communication: return "communication";
+        case Injection: return "injection";
+        case FFT: return "fft";
+        default: amrex::Abort("CostKernel::Name: unknown kernel class");
+    }
+    return "";
+}
+
+CostLedger::CostLedger (int nboxes, const DistributionMapping& dm)
+    : m_nboxes(nboxes), m_dm(dm), m_costs(nboxes*CostKernel::NKernels, 0.)
+{
+    const int myproc = ParallelDescriptor::MyProc();
+    for (int i = 0; i < m_nboxes; ++i) {
+        if (m_dm[i] == myproc) m_local_boxes.push_back(i);
+    }
+}
+
+void
+CostLedger::AddToLocalBoxes (int kernel, Real seconds)
+{
+    if (m_local_boxes.empty()) return;
+    const Real share = seconds/m_local_boxes.size();
+    for (int i : m_local_boxes) Add(i, kernel, share);
+}
+
+void
+CostLedger::Scale (Real factor)
+{
+    for (auto& c : m_costs) c *= factor;
+}
+
+void
+CostLedger::Reset ()
+{
+    std::fill(m_costs.begin(), m_costs.end(), 0.);
+}
+
+Vector<Real>
+CostLedger::KernelCosts () const
+{
+    Vector<Real> costs = m_costs;
+    ParallelDescriptor::ReduceRealSum(costs.data(), costs.size());
+    return costs;
+}
+
+Vector<Real>
+CostLedger::BoxCosts () const
+{
+    const Vector<Real> kernel_costs = KernelCosts();
+    Vector<Real> costs(m_nboxes, 0.);
+    for (int i = 0; i < m_nboxes; ++i) {
+        for (int kernel = 0; kernel < CostKernel::NKernels; ++kernel) {
+            if (!CostKernel::PerProcess(kernel)) {
+                costs[i] += kernel_costs[i*CostKernel::NKernels + kernel];
+            }
+        }
+    }
+    return costs;
+}
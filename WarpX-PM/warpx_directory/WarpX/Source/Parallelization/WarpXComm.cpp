@@ -364,6 +364,8 @@ WarpX::FillBoundaryE(int lev, IntVect ng, IntVect ng_extra_fine)
 void
 WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
 {
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -384,9 +386,8 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE, requested more guard cells than allocated");
-            Efield_fp[lev][0]->FillBoundary(ng, period);
-            Efield_fp[lev][1]->FillBoundary(ng, period);
-            Efield_fp[lev][2]->FillBoundary(ng, period);
+            Vector<MultiFab*> mf{Efield_fp[lev][0].get(),Efield_fp[lev][1].get(),Efield_fp[lev][2].get()};
+            amrex::FillBoundary(mf, ng, period);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -409,11 +410,12 @@ WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Efield_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryE, requested more guard cells than allocated");
-            Efield_cp[lev][0]->FillBoundary(ng, cperiod);
-            Efield_cp[lev][1]->FillBoundary(ng, cperiod);
-            Efield_cp[lev][2]->FillBoundary(ng, cperiod);
+            Vector<MultiFab*> mf{Efield_cp[lev][0].get(),Efield_cp[lev][1].get(),Efield_cp[lev][2].get()};
+            amrex::FillBoundary(mf, ng, cperiod);
         }
     }
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
@@ -426,6 +428,8 @@ WarpX::FillBoundaryB (int lev, IntVect ng, IntVect ng_extra_fine)
 void
 WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
 {
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     if (patch_type == PatchType::fine)
     {
         if (do_pml && pml[lev]->ok())
@@ -445,9 +449,8 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_fp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB, requested more guard cells than allocated");
-            Bfield_fp[lev][0]->FillBoundary(ng, period);
-            Bfield_fp[lev][1]->FillBoundary(ng, period);
-            Bfield_fp[lev][2]->FillBoundary(ng, period);
+            Vector<MultiFab*> mf{Bfield_fp[lev][0].get(),Bfield_fp[lev][1].get(),Bfield_fp[lev][2].get()};
+            amrex::FillBoundary(mf, ng, period);
         }
     }
     else if (patch_type == PatchType::coarse)
@@ -469,11 +472,12 @@ WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
             AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
                 ng <= Bfield_cp[lev][0]->nGrowVect(),
                 "Error: in FillBoundaryB, requested more guard cells than allocated");
-            Bfield_cp[lev][0]->FillBoundary(ng, cperiod);
-            Bfield_cp[lev][1]->FillBoundary(ng, cperiod);
-            Bfield_cp[lev][2]->FillBoundary(ng, cperiod);
+            Vector<MultiFab*> mf{Bfield_cp[lev][0].get(),Bfield_cp[lev][1].get(),Bfield_cp[lev][2].get()};
+            amrex::FillBoundary(mf, ng, cperiod);
         }
     }
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
@@ -486,6 +490,8 @@ WarpX::FillBoundaryF (int lev, IntVect ng)
 void
 WarpX::FillBoundaryF (int lev, PatchType patch_type, IntVect ng)
 {
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     if (patch_type == PatchType::fine && F_fp[lev])
     {
         if (do_pml && pml[lev]->ok())
@@ -524,6 +530,8 @@ WarpX::FillBoundaryF (int lev, PatchType patch_type, IntVect ng)
             F_cp[lev]->FillBoundary(ng, cperiod);
         }
     }
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
@@ -538,13 +546,15 @@ WarpX::FillBoundaryAux (IntVect ng)
 void
 WarpX::FillBoundaryAux (int lev, IntVect ng)
 {
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     const auto& period = Geom(lev).periodicity();
-    Efield_aux[lev][0]->FillBoundary(ng, period);
-    Efield_aux[lev][1]->FillBoundary(ng, period);
-    Efield_aux[lev][2]->FillBoundary(ng, period);
-    Bfield_aux[lev][0]->FillBoundary(ng, period);
-    Bfield_aux[lev][1]->FillBoundary(ng, period);
-    Bfield_aux[lev][2]->FillBoundary(ng, period);
+    // E and B travel in the same messages
+    Vector<MultiFab*> mf{Efield_aux[lev][0].get(),Efield_aux[lev][1].get(),Efield_aux[lev][2].get(),
+                         Bfield_aux[lev][0].get(),Bfield_aux[lev][1].get(),Bfield_aux[lev][2].get()};
+    amrex::FillBoundary(mf, ng, period);
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
@@ -556,19 +566,7 @@ WarpX::SyncCurrent ()
     // summing the guard cells of the fine patch
     for (int lev = 1; lev <= finest_level; ++lev)
     {
-        current_cp[lev][0]->setVal(0.0);
-        current_cp[lev][1]->setVal(0.0);
-        current_cp[lev][2]->setVal(0.0);
-
-        const IntVect& refinement_ratio = refRatio(lev-1);
-
-        std::array<const MultiFab*,3> fine { current_fp[lev][0].get(),
-                                             current_fp[lev][1].get(),
-                                             current_fp[lev][2].get() };
-        std::array<      MultiFab*,3> crse { current_cp[lev][0].get(),
-                                             current_cp[lev][1].get(),
-                                             current_cp[lev][2].get() };
-        interpolateCurrentFineToCoarse(fine, crse, refinement_ratio[0]);
+        RestrictFromFineToCoarsePatch(lev, true, false);
     }
 
     // For each level
@@ -581,39 +579,137 @@ WarpX::SyncCurrent ()
 }
 
 void
-interpolateCurrentFineToCoarse ( std::array< amrex::MultiFab const *, 3 > const & fine,
-                                 std::array< amrex::MultiFab       *, 3 > const & coarse,
-                                 int const refinement_ratio)
+WarpX::SyncCurrentAndRho ()
+{
+    WARPX_PROFILE("SyncCurrentAndRho()");
+
+    // Restrict fine patch current and charge density onto the coarse patch,
+    // before summing the guard cells of the fine patch
+    for (int lev = 1; lev <= finest_level; ++lev)
+    {
+        RestrictFromFineToCoarsePatch(lev, true, true);
+    }
+
+    for (int lev=0; lev <= finest_level; ++lev) {
+        AddCurrentFromFineLevelandSumBoundary(lev);
+    }
+
+    if (!rho_fp[0]) return;
+    const int ncomp = rho_fp[0]->nComp();
+    for (int lev=0; lev <= finest_level; ++lev) {
+        AddRhoFromFineLevelandSumBoundary(lev, 0, ncomp);
+    }
+}
+
+namespace
+{
+    /** \brief Tile box of mfi converted to the index type typ, and grown by ng
+     *  at the edges of the valid box (like MFIter::growntilebox, but also for
+     *  the MultiFabs whose index type is not the one of the iterated MultiFab)
+     */
+    Box
+    grownTileBox (MFIter const& mfi, IndexType const typ, IntVect const& ng)
+    {
+        Box bx = mfi.tilebox(typ.ixType());
+        const Box vbx = amrex::convert(mfi.validbox(), typ);
+        for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+            if (bx.smallEnd(d) == vbx.smallEnd(d)) bx.growLo(d, ng[d]);
+            if (bx.bigEnd(d) == vbx.bigEnd(d)) bx.growHi(d, ng[d]);
+        }
+        return bx;
+    }
+
+    /** \brief Interpolate with f in the cells of wbx, and set the ncomp
+     *  components of coarse to zero in the other cells of zbx
+     */
+    template< typename F >
+    void
+    interpolateOrZero (Box const& zbx, Box const& wbx, Array4<Real> const& coarse, int const ncomp, F const& f)
+    {
+        amrex::ParallelFor(zbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            if (wbx.contains(IntVect(AMREX_D_DECL(i,j,k)))) {
+                f(i, j, k);
+            } else {
+                for (int n = 0; n < ncomp; ++n) coarse(i, j, k, n) = 0.0_rt;
+            }
+        });
+    }
+}
+
+void
+interpolateCurrentAndDensityFineToCoarse ( std::array< amrex::MultiFab const *, 3 > const & fine_j,
+                                           std::array< amrex::MultiFab       *, 3 > const & coarse_j,
+                                           amrex::MultiFab const * fine_rho,
+                                           amrex::MultiFab       * coarse_rho,
+                                           int const refinement_ratio)
 {
-    WARPX_PROFILE("interpolateCurrentFineToCoarse()");
+    WARPX_PROFILE("interpolateCurrentAndDensityFineToCoarse()");
     BL_ASSERT(refinement_ratio == 2);
-    const IntVect& ng = (fine[0]->nGrowVect() + 1) / refinement_ratio; // add equivalent no. of guards to coarse patch
 
-#ifdef _OPEMP
+    const bool do_j = coarse_j[0] != nullptr;
+    const bool do_rho = coarse_rho != nullptr;
+    if (!do_j && !do_rho) return;
+
+    // The coarse patches have the same boxes up to their index type, and the
+    // same distribution: all of them are visited by one loop over the tiles.
+    MultiFab const& crse0 = do_j ? *coarse_j[0] : *coarse_rho;
+    const std::array<MultiFab const*,3> others { coarse_j[1], coarse_j[2], coarse_rho };
+    for (MultiFab const* mf : others) {
+        BL_ASSERT(mf == nullptr || (mf->boxArray().CellEqual(crse0.boxArray()) &&
+                                    mf->DistributionMap() == crse0.DistributionMap()));
+        amrex::ignore_unused(mf);
+    }
+
+    // add equivalent no. of guards to coarse patch
+    const IntVect ng_j = do_j ? (fine_j[0]->nGrowVect() + 1) / refinement_ratio : IntVect(0);
+    const IntVect ng_rho = do_rho ? (fine_rho->nGrowVect() + 1) / refinement_ratio : IntVect(0);
+    const int nc_rho = do_rho ? fine_rho->nComp() : 0;
+
+#ifdef _OPENMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
+    // OMP in-box decomposition of coarse into tilebox
+    for (MFIter mfi(crse0, TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
-        for (int idim = 0; idim < fine.size(); ++idim)  // j-field components
-        {
-            // OMP in-box decomposition of coarse into tilebox
-            for (MFIter mfi(*coarse[idim], TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        // The interpolated values are written in the tile box grown to the outer
+        // directions of the boxes, and zero in the remaining guards of the tile
+        if (do_j) {
+            for (int idim = 0; idim < 3; ++idim)  // j-field components
             {
-                const Box& bx = mfi.growntilebox(ng); // only grow to outer directions of tileboxes for filling guards
+                MultiFab& crse = *coarse_j[idim];
+                const Box zbx = grownTileBox(mfi, crse.ixType(), crse.nGrowVect());
+                const Box wbx = grownTileBox(mfi, crse.ixType(), ng_j);
 
-                auto const & arrFine = fine[idim]->const_array(mfi);
-                auto const & arrCoarse = coarse[idim]->array(mfi);
+                auto const & arrFine = fine_j[idim]->const_array(mfi);
+                auto const & arrCoarse = crse.array(mfi);
 
                 if( idim == 0 )
-                    amrex::ParallelFor( bx, InterpolateCurrentFineToCoarse<0>(arrFine, arrCoarse, refinement_ratio) );
+                    interpolateOrZero( zbx, wbx, arrCoarse, 1, InterpolateCurrentFineToCoarse<0>(arrFine, arrCoarse, refinement_ratio) );
                 else if( idim == 1 )
-                    amrex::ParallelFor( bx, InterpolateCurrentFineToCoarse<1>(arrFine, arrCoarse, refinement_ratio) );
+                    interpolateOrZero( zbx, wbx, arrCoarse, 1, InterpolateCurrentFineToCoarse<1>(arrFine, arrCoarse, refinement_ratio) );
                 else if( idim == 2 )
-                    amrex::ParallelFor( bx, InterpolateCurrentFineToCoarse<2>(arrFine, arrCoarse, refinement_ratio) );
+                    interpolateOrZero( zbx, wbx, arrCoarse, 1, InterpolateCurrentFineToCoarse<2>(arrFine, arrCoarse, refinement_ratio) );
             }
         }
+        if (do_rho) {
+            const Box zbx = grownTileBox(mfi, coarse_rho->ixType(), coarse_rho->nGrowVect());
+            const Box wbx = grownTileBox(mfi, coarse_rho->ixType(), ng_rho);
+            auto const & arrCoarse = coarse_rho->array(mfi);
+            interpolateOrZero( zbx, wbx, arrCoarse, nc_rho,
+                InterpolateDensityFineToCoarse(fine_rho->const_array(mfi), arrCoarse, refinement_ratio, nc_rho) );
+        }
     }
 }
 
+void
+interpolateCurrentFineToCoarse ( std::array< amrex::MultiFab const *, 3 > const & fine,
+                                 std::array< amrex::MultiFab       *, 3 > const & coarse,
+                                 int const refinement_ratio)
+{
+    interpolateCurrentAndDensityFineToCoarse(fine, coarse, nullptr, nullptr, refinement_ratio);
+}
+
 void
 WarpX::SyncRho ()
 {
@@ -626,9 +722,7 @@ WarpX::SyncRho ()
     // before summing the guard cells of the fine patch
     for (int lev = 1; lev <= finest_level; ++lev)
     {
-        rho_cp[lev]->setVal(0.0);
-        const IntVect& refinement_ratio = refRatio(lev-1);
-        interpolateDensityFineToCoarse(*rho_fp[lev], *rho_cp[lev], refinement_ratio[0]);
+        RestrictFromFineToCoarsePatch(lev, false, true);
     }
 
     // For each level
@@ -643,26 +737,8 @@ WarpX::SyncRho ()
 void
 interpolateDensityFineToCoarse (const MultiFab& fine, MultiFab& coarse, int const refinement_ratio)
 {
-    WARPX_PROFILE("interpolateDensityFineToCoarse()");
-    BL_ASSERT(refinement_ratio == 2);
-    const IntVect& ng = (fine.nGrowVect() + 1) / refinement_ratio;  // add equivalent no. of guards to coarse patch
-    const int nc = fine.nComp();
-
-#ifdef _OPEMP
-#pragma omp parallel if (Gpu::notInLaunchRegion())
-#endif
-    {
-        // OMP in-box decomposition of coarse into tilebox
-        for (MFIter mfi(coarse, TilingIfNotGPU()); mfi.isValid(); ++mfi)
-        {
-            const Box& bx = mfi.growntilebox(ng); // only grow to outer directions of tileboxes for filling guards
-
-            amrex::ParallelFor(
-                bx,
-                InterpolateDensityFineToCoarse(fine.const_array(mfi), coarse.array(mfi), refinement_ratio, nc)
-            );
-        }
-    }
+    interpolateCurrentAndDensityFineToCoarse({nullptr, nullptr, nullptr}, {nullptr, nullptr, nullptr},
+                                             &fine, &coarse, refinement_ratio);
 }
 
 /** \brief Fills the values of the current on the coarse patch by
@@ -671,19 +747,25 @@ interpolateDensityFineToCoarse (const MultiFab& fine, MultiFab& coarse, int cons
 void
 WarpX::RestrictCurrentFromFineToCoarsePatch (int lev)
 {
-    current_cp[lev][0]->setVal(0.0);
-    current_cp[lev][1]->setVal(0.0);
-    current_cp[lev][2]->setVal(0.0);
+    RestrictFromFineToCoarsePatch(lev, true, false);
+}
 
+void
+WarpX::RestrictFromFineToCoarsePatch (int lev, bool restrict_current, bool restrict_rho)
+{
     const IntVect& refinement_ratio = refRatio(lev-1);
 
-    std::array<const MultiFab*,3> fine { current_fp[lev][0].get(),
-                                         current_fp[lev][1].get(),
-                                         current_fp[lev][2].get() };
-    std::array<      MultiFab*,3> crse { current_cp[lev][0].get(),
-                                         current_cp[lev][1].get(),
-                                         current_cp[lev][2].get() };
-    interpolateCurrentFineToCoarse(fine, crse, refinement_ratio[0]);
+    std::array<const MultiFab*,3> fine { nullptr, nullptr, nullptr };
+    std::array<      MultiFab*,3> crse { nullptr, nullptr, nullptr };
+    if (restrict_current) {
+        fine = { current_fp[lev][0].get(), current_fp[lev][1].get(), current_fp[lev][2].get() };
+        crse = { current_cp[lev][0].get(), current_cp[lev][1].get(), current_cp[lev][2].get() };
+    }
+    const bool do_rho = restrict_rho && rho_fp[lev];
+    interpolateCurrentAndDensityFineToCoarse(fine, crse,
+                                             do_rho ? rho_fp[lev].get() : nullptr,
+                                             do_rho ? rho_cp[lev].get() : nullptr,
+                                             refinement_ratio[0]);
 }
 
 void
@@ -696,9 +778,9 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
         if (use_filter) {
             IntVect ng = j[idim]->nGrowVect();
             ng += bilinear_filter.stencil_length_each_dir-1;
-            MultiFab jf(j[idim]->boxArray(), j[idim]->DistributionMap(), j[idim]->nComp(), ng);
-            bilinear_filter.ApplyStencil(jf, *j[idim]);
-            WarpXSumGuardCells(*(j[idim]), jf, period, 0, (j[idim])->nComp());
+            auto jf = scratch_pool->Get(j[idim]->boxArray(), j[idim]->DistributionMap(), j[idim]->nComp(), ng);
+            bilinear_filter.ApplyStencil(*jf, *j[idim]);
+            WarpXSumGuardCells(*(j[idim]), *jf, period, 0, (j[idim])->nComp());
         } else {
             WarpXSumGuardCells(*(j[idim]), period, 0, (j[idim])->nComp());
         }
@@ -721,45 +803,54 @@ WarpX::ApplyFilterandSumBoundaryJ (int lev, PatchType patch_type)
 void
 WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
 {
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     ApplyFilterandSumBoundaryJ(lev, PatchType::fine);
 
     if (lev < finest_level) {
         // When there are current buffers, unlike coarse patch,
         // we don't care about the final state of them.
 
+        // The coarse patch/buffer of each component is sent to the fine patch of
+        // `lev` while the next components are filtered and their guard cells
+        // summed. The sources of the messages are kept until they are received.
         const auto& period = Geom(lev).periodicity();
+        std::array<ScratchFieldPool::MultiFabPtr,3> mf;
+        std::array<ScratchFieldPool::MultiFabPtr,3> jsrc;
         for (int idim = 0; idim < 3; ++idim) {
-            MultiFab mf(current_fp[lev][idim]->boxArray(),
-                        current_fp[lev][idim]->DistributionMap(), current_fp[lev][idim]->nComp(), 0);
-            mf.setVal(0.0);
+            mf[idim] = scratch_pool->Get(current_fp[lev][idim]->boxArray(),
+                                         current_fp[lev][idim]->DistributionMap(), current_fp[lev][idim]->nComp(), 0);
+            mf[idim]->setVal(0.0);
             if (use_filter && current_buf[lev+1][idim])
             {
                 // coarse patch of fine level
                 IntVect ng = current_cp[lev+1][idim]->nGrowVect();
                 ng += bilinear_filter.stencil_length_each_dir-1;
-                MultiFab jfc(current_cp[lev+1][idim]->boxArray(),
-                             current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
-                bilinear_filter.ApplyStencil(jfc, *current_cp[lev+1][idim]);
+                auto jfc = scratch_pool->Get(current_cp[lev+1][idim]->boxArray(),
+                                             current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
+                bilinear_filter.ApplyStencil(*jfc, *current_cp[lev+1][idim]);
 
                 // buffer patch of fine level
-                MultiFab jfb(current_buf[lev+1][idim]->boxArray(),
-                             current_buf[lev+1][idim]->DistributionMap(), current_buf[lev+1][idim]->nComp(), ng);
+                jsrc[idim] = scratch_pool->Get(current_buf[lev+1][idim]->boxArray(),
+                                               current_buf[lev+1][idim]->DistributionMap(), current_buf[lev+1][idim]->nComp(), ng);
+                MultiFab& jfb = *jsrc[idim];
                 bilinear_filter.ApplyStencil(jfb, *current_buf[lev+1][idim]);
 
-                MultiFab::Add(jfb, jfc, 0, 0, current_buf[lev+1][idim]->nComp(), ng);
-                mf.ParallelAdd(jfb, 0, 0, current_buf[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
+                MultiFab::Add(jfb, *jfc, 0, 0, current_buf[lev+1][idim]->nComp(), ng);
+                mf[idim]->ParallelAdd_nowait(jfb, 0, 0, current_buf[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
 
-                WarpXSumGuardCells(*current_cp[lev+1][idim], jfc, period, 0, current_cp[lev+1][idim]->nComp());
+                WarpXSumGuardCells(*current_cp[lev+1][idim], *jfc, period, 0, current_cp[lev+1][idim]->nComp());
             }
             else if (use_filter) // but no buffer
             {
                 // coarse patch of fine level
                 IntVect ng = current_cp[lev+1][idim]->nGrowVect();
                 ng += bilinear_filter.stencil_length_each_dir-1;
-                MultiFab jf(current_cp[lev+1][idim]->boxArray(),
-                            current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
+                jsrc[idim] = scratch_pool->Get(current_cp[lev+1][idim]->boxArray(),
+                                               current_cp[lev+1][idim]->DistributionMap(), current_cp[lev+1][idim]->nComp(), ng);
+                MultiFab& jf = *jsrc[idim];
                 bilinear_filter.ApplyStencil(jf, *current_cp[lev+1][idim]);
-                mf.ParallelAdd(jf, 0, 0, current_cp[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
+                mf[idim]->ParallelAdd_nowait(jf, 0, 0, current_cp[lev+1][idim]->nComp(), ng, IntVect::TheZeroVector(), period);
                 WarpXSumGuardCells(*current_cp[lev+1][idim], jf, period, 0, current_cp[lev+1][idim]->nComp());
             }
             else if (current_buf[lev+1][idim]) // but no filter
@@ -767,33 +858,35 @@ WarpX::AddCurrentFromFineLevelandSumBoundary (int lev)
                 MultiFab::Add(*current_buf[lev+1][idim],
                                *current_cp [lev+1][idim], 0, 0, current_buf[lev+1][idim]->nComp(),
                                current_cp[lev+1][idim]->nGrow());
-                mf.ParallelAdd(*current_buf[lev+1][idim], 0, 0, current_buf[lev+1][idim]->nComp(),
-                               current_buf[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                               period);
+                mf[idim]->ParallelAdd_nowait(*current_buf[lev+1][idim], 0, 0, current_buf[lev+1][idim]->nComp(),
+                                            current_buf[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
+                                            period);
                 WarpXSumGuardCells(*(current_cp[lev+1][idim]), period, 0, current_cp[lev+1][idim]->nComp());
             }
             else // no filter, no buffer
             {
-                mf.ParallelAdd(*current_cp[lev+1][idim], 0, 0, current_cp[lev+1][idim]->nComp(),
-                               current_cp[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
-                               period);
+                // the values to send are packed before the guard cells are summed
+                mf[idim]->ParallelAdd_nowait(*current_cp[lev+1][idim], 0, 0, current_cp[lev+1][idim]->nComp(),
+                                            current_cp[lev+1][idim]->nGrowVect(), IntVect::TheZeroVector(),
+                                            period);
                 WarpXSumGuardCells(*(current_cp[lev+1][idim]), period, 0, current_cp[lev+1][idim]->nComp());
             }
-            MultiFab::Add(*current_fp[lev][idim], mf, 0, 0, current_fp[lev+1][idim]->nComp(), 0);
+        }
+        for (int idim = 0; idim < 3; ++idim) {
+            mf[idim]->ParallelCopy_finish();
+            MultiFab::Add(*current_fp[lev][idim], *mf[idim], 0, 0, current_fp[lev+1][idim]->nComp(), 0);
         }
         NodalSyncJ(lev+1, PatchType::coarse);
     }
     NodalSyncJ(lev, PatchType::fine);
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
 WarpX::RestrictRhoFromFineToCoarsePatch (int lev)
 {
-    if (rho_fp[lev]) {
-        rho_cp[lev]->setVal(0.0);
-        const IntVect& refinement_ratio = refRatio(lev-1);
-        interpolateDensityFineToCoarse(*rho_fp[lev], *rho_cp[lev], refinement_ratio[0]);
-    }
+    RestrictFromFineToCoarsePatch(lev, false, true);
 }
 
 void
@@ -806,9 +899,9 @@ WarpX::ApplyFilterandSumBoundaryRho (int lev, PatchType patch_type, int icomp, i
     if (use_filter) {
         IntVect ng = r->nGrowVect();
         ng += bilinear_filter.stencil_length_each_dir-1;
-        MultiFab rf(r->boxArray(), r->DistributionMap(), ncomp, ng);
-        bilinear_filter.ApplyStencil(rf, *r, icomp, 0, ncomp);
-        WarpXSumGuardCells(*r, rf, period, icomp, ncomp );
+        auto rf = scratch_pool->Get(r->boxArray(), r->DistributionMap(), ncomp, ng);
+        bilinear_filter.ApplyStencil(*rf, *r, icomp, 0, ncomp);
+        WarpXSumGuardCells(*r, *rf, period, icomp, ncomp );
     } else {
         WarpXSumGuardCells(*r, period, icomp, ncomp);
     }
@@ -832,40 +925,47 @@ WarpX::AddRhoFromFineLevelandSumBoundary(int lev, int icomp, int ncomp)
 {
     if (!rho_fp[lev]) return;
 
+    CostTimer comm_timer(WarpX::getCosts(lev), CostTimer::LocalBoxes);
+
     ApplyFilterandSumBoundaryRho(lev, PatchType::fine, icomp, ncomp);
 
     if (lev < finest_level){
 
         const auto& period = Geom(lev).periodicity();
-        MultiFab mf(rho_fp[lev]->boxArray(),
-                    rho_fp[lev]->DistributionMap(),
-                    ncomp, 0);
-        mf.setVal(0.0);
+        auto mf = scratch_pool->Get(rho_fp[lev]->boxArray(),
+                                    rho_fp[lev]->DistributionMap(),
+                                    ncomp, 0);
+        mf->setVal(0.0);
+        // The source of the addition to the fine patch of `lev` is kept until
+        // the messages are received, after the guard cells are summed
+        ScratchFieldPool::MultiFabPtr rsrc;
         if (use_filter && charge_buf[lev+1])
         {
             // coarse patch of fine level
             IntVect ng = rho_cp[lev+1]->nGrowVect();
             ng += bilinear_filter.stencil_length_each_dir-1;
-            MultiFab rhofc(rho_cp[lev+1]->boxArray(),
-                         rho_cp[lev+1]->DistributionMap(), ncomp, ng);
-            bilinear_filter.ApplyStencil(rhofc, *rho_cp[lev+1], icomp, 0, ncomp);
+            auto rhofc = scratch_pool->Get(rho_cp[lev+1]->boxArray(),
+                                           rho_cp[lev+1]->DistributionMap(), ncomp, ng);
+            bilinear_filter.ApplyStencil(*rhofc, *rho_cp[lev+1], icomp, 0, ncomp);
 
             // buffer patch of fine level
-            MultiFab rhofb(charge_buf[lev+1]->boxArray(),
-                           charge_buf[lev+1]->DistributionMap(), ncomp, ng);
+            rsrc = scratch_pool->Get(charge_buf[lev+1]->boxArray(),
+                                     charge_buf[lev+1]->DistributionMap(), ncomp, ng);
+            MultiFab& rhofb = *rsrc;
             bilinear_filter.ApplyStencil(rhofb, *charge_buf[lev+1], icomp, 0, ncomp);
 
-            MultiFab::Add(rhofb, rhofc, 0, 0, ncomp, ng);
-            mf.ParallelAdd(rhofb, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
-            WarpXSumGuardCells( *rho_cp[lev+1], rhofc, period, icomp, ncomp );
+            MultiFab::Add(rhofb, *rhofc, 0, 0, ncomp, ng);
+            mf->ParallelAdd_nowait(rhofb, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
+            WarpXSumGuardCells( *rho_cp[lev+1], *rhofc, period, icomp, ncomp );
         }
         else if (use_filter) // but no buffer
         {
             IntVect ng = rho_cp[lev+1]->nGrowVect();
             ng += bilinear_filter.stencil_length_each_dir-1;
-            MultiFab rf(rho_cp[lev+1]->boxArray(), rho_cp[lev+1]->DistributionMap(), ncomp, ng);
+            rsrc = scratch_pool->Get(rho_cp[lev+1]->boxArray(), rho_cp[lev+1]->DistributionMap(), ncomp, ng);
+            MultiFab& rf = *rsrc;
             bilinear_filter.ApplyStencil(rf, *rho_cp[lev+1], icomp, 0, ncomp);
-            mf.ParallelAdd(rf, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
+            mf->ParallelAdd_nowait(rf, 0, 0, ncomp, ng, IntVect::TheZeroVector(), period);
             WarpXSumGuardCells( *rho_cp[lev+1], rf, period, icomp, ncomp );
         }
         else if (charge_buf[lev+1]) // but no filter
@@ -873,24 +973,27 @@ WarpX::AddRhoFromFineLevelandSumBoundary(int lev, int icomp, int ncomp)
             MultiFab::Add(*charge_buf[lev+1],
                            *rho_cp[lev+1], icomp, icomp, ncomp,
                            rho_cp[lev+1]->nGrow());
-            mf.ParallelAdd(*charge_buf[lev+1], icomp, 0,
-                           ncomp,
-                           charge_buf[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
+            mf->ParallelAdd_nowait(*charge_buf[lev+1], icomp, 0,
+                                   ncomp,
+                                   charge_buf[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
+                                   period);
             WarpXSumGuardCells(*(rho_cp[lev+1]), period, icomp, ncomp);
         }
         else // no filter, no buffer
         {
-            mf.ParallelAdd(*rho_cp[lev+1], icomp, 0, ncomp,
-                           rho_cp[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
-                           period);
+            mf->ParallelAdd_nowait(*rho_cp[lev+1], icomp, 0, ncomp,
+                                   rho_cp[lev+1]->nGrowVect(), IntVect::TheZeroVector(),
+                                   period);
             WarpXSumGuardCells(*(rho_cp[lev+1]), period, icomp, ncomp);
         }
-        MultiFab::Add(*rho_fp[lev], mf, 0, icomp, ncomp, 0);
+        mf->ParallelCopy_finish();
+        MultiFab::Add(*rho_fp[lev], *mf, 0, icomp, ncomp, 0);
         NodalSyncRho(lev+1, PatchType::coarse, icomp, ncomp);
     }
 
     NodalSyncRho(lev, PatchType::fine, icomp, ncomp);
+
+    comm_timer.Charge(CostKernel::Communication);
 }
 
 void
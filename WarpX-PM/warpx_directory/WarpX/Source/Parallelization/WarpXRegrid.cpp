@@ -10,6 +10,12 @@
 #include <WarpXAlgorithmSelection.H>
 #include <AMReX_BLProfiler.H>
 
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
 using namespace amrex;
 
 void
@@ -20,65 +26,207 @@ WarpX::LoadBalance ()
 
     if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
     {
-        LoadBalanceTimers();
+        AMREX_ALWAYS_ASSERT(costs[0] != nullptr);
     } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic)
     {
-        LoadBalanceHeuristic();
+        AMREX_ALWAYS_ASSERT(costs_heuristic[0] != nullptr);
+        WarpX::ComputeCostsHeuristic(costs_heuristic);
+    }
+
+    bool remade = false;
+    const int nLevels = finestLevel();
+    for (int lev = 0; lev <= nLevels; ++lev)
+    {
+        amrex::Vector<Real> box_costs;
+        if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
+        {
+            // Costs of the boxes summed over the processes
+            box_costs = costs[lev]->BoxCosts();
+        } else
+        {
+            box_costs = *costs_heuristic[lev];
+#ifdef AMREX_USE_MPI
+            // Parallel reduce the costs_heurisitc
+            ParallelAllReduce::Sum(box_costs.data(), box_costs.size(),
+                                   ParallelContext::CommunicatorSub());
+#endif
+        }
+        remade = LoadBalanceLevel(lev, box_costs) || remade;
+    }
+    // Only the particles of the boxes that changed owners are sent
+    if (remade) {
+        mypc->Redistribute();
+        PostRemakeLevels();
     }
 }
 
 void
-WarpX::LoadBalanceTimers ()
+WarpX::Regrid ()
 {
-    AMREX_ALWAYS_ASSERT(costs[0] != nullptr);
+    WARPX_PROFILE_REGION("Regrid");
+    WARPX_PROFILE("WarpX::Regrid()");
 
-    const int nLevels = finestLevel();
-    for (int lev = 0; lev <= nLevels; ++lev)
-    {
-        const Real nboxes = costs[lev]->size();
-        const Real nprocs = ParallelDescriptor::NProcs();
-        const int nmax = static_cast<int>(std::ceil(nboxes/nprocs*load_balance_knapsack_factor));
-        const DistributionMapping newdm = (load_balance_with_sfc)
-            ? DistributionMapping::makeSFC(*costs[lev], false)
-            : DistributionMapping::makeKnapSack(*costs[lev], nmax);
-        RemakeLevel(lev, t_new[lev], boxArray(lev), newdm);
+    const int old_finest_level = finest_level;
+    Vector<BoxArray> old_grids(finest_level+1);
+    for (int lev = 0; lev <= finest_level; ++lev) old_grids[lev] = boxArray(lev);
+
+    // Tags the cells of the levels and remakes the levels whose grids change
+    AmrCore::regrid(0, t_new[0]);
+
+    bool changed = (finest_level != old_finest_level);
+    for (int lev = 1; lev <= std::min(finest_level, old_finest_level); ++lev) {
+        changed = changed || (boxArray(lev) != old_grids[lev]);
     }
+    if (!changed) return;
+
     mypc->Redistribute();
+    PostRemakeLevels();
+
+    if (verbose) {
+        amrex::Print() << "Regrid: " << finest_level+1 << " levels";
+        for (int lev = 1; lev <= finest_level; ++lev) {
+            amrex::Print() << "; level " << lev << ": " << boxArray(lev).size() << " boxes, "
+                           << boxArray(lev).numPts() << " cells";
+        }
+        amrex::Print() << "\n";
+    }
 }
 
 void
-WarpX::LoadBalanceHeuristic ()
+WarpX::PostRemakeLevels ()
 {
-    AMREX_ALWAYS_ASSERT(costs_heuristic[0] != nullptr);
-    WarpX::ComputeCostsHeuristic(costs_heuristic);
+    BuildBufferMasks();
+    // The diagnostics keep pointers to the fields
+    multi_diags->InitializeFieldFunctors();
+}
 
-    const int nLevels = finestLevel();
-    for (int lev = 0; lev <= nLevels; ++lev)
-    {
-#ifdef AMREX_USE_MPI
-        // Parallel reduce the costs_heurisitc
-        amrex::Vector<Real>::iterator it = (*costs_heuristic[lev]).begin();
-        amrex::Real* itAddr = &(*it);
-        ParallelAllReduce::Sum(itAddr,
-                               costs_heuristic[lev]->size(),
-                               ParallelContext::CommunicatorSub());
-#endif
-        const amrex::Real nboxes = costs_heuristic[lev]->size();
-        const amrex::Real nprocs = ParallelContext::NProcsSub();
-        const int nmax = static_cast<int>(std::ceil(nboxes/nprocs*load_balance_knapsack_factor));
+bool
+WarpX::LoadBalanceLevel (int lev, const amrex::Vector<Real>& box_costs)
+{
+    const DistributionMapping& olddm = DistributionMap(lev);
+    const Real nboxes = box_costs.size();
+    const int nprocs = ParallelContext::NProcsSub();
+    const int nmax = static_cast<int>(std::ceil(nboxes/nprocs*load_balance_knapsack_factor));
+    const DistributionMapping proposeddm = (load_balance_with_sfc)
+        ? DistributionMapping::makeSFC(box_costs, boxArray(lev), false)
+        : DistributionMapping::makeKnapSack(box_costs, nmax);
 
-        const DistributionMapping newdm = (load_balance_with_sfc)
-            ? DistributionMapping::makeSFC(*costs_heuristic[lev], boxArray(lev), false)
-            : DistributionMapping::makeKnapSack(*costs_heuristic[lev], nmax);
+    // The processes of the proposed mapping are only labels: relabel them so
+    // that the boxes keep their owners as much as possible. Pairs of proposed
+    // and current owners are matched by decreasing bytes in common.
+    const amrex::Vector<Real> box_bytes = LoadBalanceBoxBytes(lev);
+    std::map<std::pair<int,int>, Real> common_bytes;
+    for (int i = 0; i < box_bytes.size(); ++i) {
+        // At least one byte, so that all the boxes count
+        common_bytes[std::make_pair(proposeddm[i], olddm[i])] += box_bytes[i] + 1.;
+    }
+    std::vector<std::pair<Real, std::pair<int,int> > > matches;
+    for (const auto& kv : common_bytes) matches.emplace_back(kv.second, kv.first);
+    std::stable_sort(matches.begin(), matches.end(),
+                     [] (const std::pair<Real, std::pair<int,int> >& a,
+                         const std::pair<Real, std::pair<int,int> >& b)
+                     { return a.first > b.first; });
+    amrex::Vector<int> relabel(nprocs, -1);
+    amrex::Vector<int> taken(nprocs, 0);
+    for (const auto& m : matches) {
+        const int proposed = m.second.first;
+        const int current = m.second.second;
+        if (relabel[proposed] < 0 && !taken[current]) {
+            relabel[proposed] = current;
+            taken[current] = 1;
+        }
+    }
+    int next_free = 0;
+    for (int proc = 0; proc < nprocs; ++proc) {
+        if (relabel[proc] >= 0) continue;
+        while (taken[next_free]) ++next_free;
+        relabel[proc] = next_free;
+        taken[next_free] = 1;
+    }
+    amrex::Vector<int> pmap(box_costs.size());
+    for (int i = 0; i < pmap.size(); ++i) pmap[i] = relabel[proposeddm[i]];
+    const DistributionMapping newdm(std::move(pmap));
+
+    LoadBalanceDecision& decision = m_load_balance_decisions[lev];
+    decision.current_efficiency = LoadBalanceEfficiency(olddm, box_costs);
+    decision.proposed_efficiency = LoadBalanceEfficiency(newdm, box_costs);
+    decision.adopted = (decision.proposed_efficiency >
+                        load_balance_efficiency_ratio_threshold*decision.current_efficiency);
+    decision.boxes_moved = 0;
+    decision.bytes_moved = 0.;
+    if (!decision.adopted) return false;
 
-        RemakeLevel(lev, t_new[lev], boxArray(lev), newdm);
+    for (int i = 0; i < box_bytes.size(); ++i) {
+        if (newdm[i] != olddm[i]) {
+            decision.boxes_moved += 1;
+            decision.bytes_moved += box_bytes[i];
+        }
     }
-    mypc->Redistribute();
+    if (decision.boxes_moved == 0) return false;
+
+    RemakeLevel(lev, t_new[lev], boxArray(lev), newdm);
+    return true;
+}
+
+Real
+WarpX::LoadBalanceEfficiency (const DistributionMapping& dm, const amrex::Vector<Real>& box_costs)
+{
+    amrex::Vector<Real> proc_costs(ParallelContext::NProcsSub(), 0.);
+    for (int i = 0; i < box_costs.size(); ++i) {
+        proc_costs[dm[i]] += box_costs[i];
+    }
+    const Real max_cost = *std::max_element(proc_costs.begin(), proc_costs.end());
+    if (max_cost <= 0.) return 1.;
+    const Real sum_cost = std::accumulate(proc_costs.begin(), proc_costs.end(), Real(0.));
+    return sum_cost/(proc_costs.size()*max_cost);
+}
+
+amrex::Vector<Real>
+WarpX::LoadBalanceBoxBytes (int lev)
+{
+    amrex::Vector<Real> bytes(boxArray(lev).size(), 0.);
+
+    // Fields redistributed by RemakeLevel
+    auto add_field = [&bytes] (const MultiFab* mf) {
+        if (mf == nullptr) return;
+        for (MFIter mfi(*mf); mfi.isValid(); ++mfi) {
+            bytes[mfi.index()] += mfi.fabbox().numPts()*mf->nComp()*sizeof(Real);
+        }
+    };
+    for (int idim = 0; idim < 3; ++idim) {
+        add_field(Efield_fp[lev][idim].get());
+        add_field(Bfield_fp[lev][idim].get());
+        add_field(Efield_cp[lev][idim].get());
+        add_field(Bfield_cp[lev][idim].get());
+    }
+    add_field(F_fp[lev].get());
+    add_field(F_cp[lev].get());
+
+    // Particles
+    for (int i_s = 0; i_s < mypc->nSpecies(); ++i_s)
+    {
+        auto& pc = mypc->GetParticleContainer(i_s);
+        for (WarpXParIter pti(pc, lev); pti.isValid(); ++pti)
+        {
+            const auto& ptile = pti.GetParticleTile();
+            const Real particle_bytes = sizeof(WarpXParticleContainer::ParticleType)
+                + ptile.NumRealComps()*sizeof(ParticleReal) + ptile.NumIntComps()*sizeof(int);
+            bytes[pti.index()] += pti.numParticles()*particle_bytes;
+        }
+    }
+
+    ParallelDescriptor::ReduceRealSum(bytes.data(), bytes.size());
+    return bytes;
 }
 
 void
-WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const DistributionMapping& dm)
+WarpX::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapping& dm)
 {
+    // The scratch fields are defined on the grids of the levels
+    scratch_pool->Clear();
+    // So are the operator and multigrid hierarchy of the Poisson solver
+    m_poisson_solver.reset();
+
     if (ba == boxArray(lev))
     {
         if (ParallelDescriptor::NProcs() == 1) return;
@@ -133,6 +281,12 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
             rho_fp[lev] = std::move(pmf);
         }
 
+#ifdef WARPX_USE_PSATD
+        if (spectral_solver_fp[lev] != nullptr) {
+            spectral_solver_fp[lev]->Remake(dm);
+        }
+#endif
+
         // Aux patch
         if (lev == 0 && Bfield_aux[0][0]->ixType() == Bfield_fp[0][0]->ixType())
         {
@@ -202,6 +356,12 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
                                                                   dm, nc, ng));
                 rho_cp[lev] = std::move(pmf);
             }
+
+#ifdef WARPX_USE_PSATD
+            if (spectral_solver_cp[lev] != nullptr) {
+                spectral_solver_cp[lev]->Remake(dm);
+            }
+#endif
         }
 
         if (lev > 0 && (n_field_gather_buffer > 0 || n_current_deposition_buffer > 0)) {
@@ -262,8 +422,7 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
         {
             if (costs[lev] != nullptr)
             {
-                costs[lev].reset(new MultiFab(costs[lev]->boxArray(), dm, 1, 0));
-                costs[lev]->setVal(0.0);
+                costs[lev].reset(new CostLedger(costs[lev]->size(), dm));
             }
         } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic)
         {
@@ -279,10 +438,89 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
 
     } else
     {
-        amrex::Abort("RemakeLevel: to be implemented");
+        // The grids changed: the fields are allocated on the new grids, and
+        // the fine and coarse patches are copied where the old and new grids
+        // overlap. Elsewhere, they start as at the beginning of the simulation,
+        // so that the auxiliary field is the field of the coarser level.
+        std::array<std::unique_ptr<MultiFab>, 3> old_Efield_fp, old_Bfield_fp;
+        std::array<std::unique_ptr<MultiFab>, 3> old_Efield_cp, old_Bfield_cp;
+        for (int idim = 0; idim < 3; ++idim) {
+            old_Efield_fp[idim] = std::move(Efield_fp[lev][idim]);
+            old_Bfield_fp[idim] = std::move(Bfield_fp[lev][idim]);
+            old_Efield_cp[idim] = std::move(Efield_cp[lev][idim]);
+            old_Bfield_cp[idim] = std::move(Bfield_cp[lev][idim]);
+        }
+        std::unique_ptr<MultiFab> old_F_fp = std::move(F_fp[lev]);
+        std::unique_ptr<MultiFab> old_F_cp = std::move(F_cp[lev]);
+        std::unique_ptr<PML> old_pml = std::move(pml[lev]);
+
+        ClearLevel(lev);
+        AllocLevelData(lev, ba, dm);
+        InitLevelData(lev, time);
+
+        auto copy_overlap = [] (MultiFab* dst, const MultiFab* src, const Periodicity& period) {
+            if (dst == nullptr || src == nullptr) return;
+            dst->ParallelCopy(*src, 0, 0, dst->nComp(), IntVect::TheZeroVector(),
+                              dst->nGrowVect(), period);
+        };
+        const auto& period = Geom(lev).periodicity();
+        const auto& cperiod = Geom(lev-1).periodicity();
+        for (int idim = 0; idim < 3; ++idim) {
+            copy_overlap(Efield_fp[lev][idim].get(), old_Efield_fp[idim].get(), period);
+            copy_overlap(Bfield_fp[lev][idim].get(), old_Bfield_fp[idim].get(), period);
+            copy_overlap(Efield_cp[lev][idim].get(), old_Efield_cp[idim].get(), cperiod);
+            copy_overlap(Bfield_cp[lev][idim].get(), old_Bfield_cp[idim].get(), cperiod);
+        }
+        copy_overlap(F_fp[lev].get(), old_F_fp.get(), period);
+        copy_overlap(F_cp[lev].get(), old_F_cp.get(), cperiod);
+
+        // The PML around the patch moves with it; it is made by InitPML at
+        // the initialization
+        if (old_pml) {
+            InitPMLPatch(lev, ba, dm);
+            pml[lev]->ComputePMLFactors(dt[lev]);
+            if (old_pml->ok() && pml[lev]->ok()) {
+                const auto old_E_fp = old_pml->GetE_fp();
+                const auto old_B_fp = old_pml->GetB_fp();
+                const auto old_E_cp = old_pml->GetE_cp();
+                const auto old_B_cp = old_pml->GetB_cp();
+                const auto new_E_fp = pml[lev]->GetE_fp();
+                const auto new_B_fp = pml[lev]->GetB_fp();
+                const auto new_E_cp = pml[lev]->GetE_cp();
+                const auto new_B_cp = pml[lev]->GetB_cp();
+                for (int idim = 0; idim < 3; ++idim) {
+                    copy_overlap(new_E_fp[idim], old_E_fp[idim], period);
+                    copy_overlap(new_B_fp[idim], old_B_fp[idim], period);
+                    copy_overlap(new_E_cp[idim], old_E_cp[idim], cperiod);
+                    copy_overlap(new_B_cp[idim], old_B_cp[idim], cperiod);
+                }
+                copy_overlap(pml[lev]->GetF_fp(), old_pml->GetF_fp(), period);
+                copy_overlap(pml[lev]->GetF_cp(), old_pml->GetF_cp(), cperiod);
+            }
+        }
     }
 }
 
+void
+WarpX::MakeNewLevelFromCoarse (int lev, Real time, const BoxArray& ba,
+                               const DistributionMapping& dm)
+{
+    // As for the parts of the remade levels that were not refined before,
+    // the fields of the patches start as at the beginning of the simulation,
+    // so that the auxiliary field is the field of the coarser level.
+    AllocLevelData(lev, ba, dm);
+    InitLevelData(lev, time);
+
+    // The PML of the initial levels are made by InitPML
+    if (do_pml && pml[0]) {
+        InitPMLPatch(lev, ba, dm);
+        pml[lev]->ComputePMLFactors(dt[lev]);
+    }
+
+    istep[lev] = istep[lev-1];
+    t_new[lev] = time;
+}
+
 void
 WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::Vector<amrex::Real> > >& costs)
 {
@@ -320,7 +558,7 @@ WarpX::ResetCosts ()
     {
         if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
-            costs[lev]->setVal(0.0);
+            costs[lev]->Reset();
         } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic)
         {
             costs_heuristic[lev]->assign((*costs_heuristic[lev]).size(), 0.0);
@@ -0,0 +1,305 @@
+#include "wp_parser_bc.h"
+
+#include <AMReX.H>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <map>
+#include <set>
+#include <tuple>
+
+namespace {
+
+/* A value of the expression.  Values are numbered in the order in
+ * which they are created, so that the operands of a value always have
+ * smaller numbers.  The first nvars values are the arguments.
+ */
+struct wp_bc_value {
+    int op;        /* 0 for an argument */
+    int f;
+    int a;         /* value number of the operands */
+    int b;
+    amrex_real v;
+};
+
+class wp_bc_compiler
+{
+public:
+    wp_bc_compiler (std::vector<std::string> const& varnames, bool cse)
+        : m_varnames(varnames), m_cse(cse)
+    {
+        for (int i = 0; i < static_cast<int>(varnames.size()); ++i) {
+            m_values.push_back({0, 0, -1, -1, 0.0});
+        }
+    }
+
+    int compile (struct wp_node* node);
+
+    std::vector<wp_bc_value> const& values () const { return m_values; }
+
+private:
+    using key_type = std::tuple<int,int,int,int,unsigned long long>;
+
+    int value (int op, int f, int a, int b, amrex_real v);
+    int constant (amrex_real v) { return value(WP_BC_CONST, 0, -1, -1, v); }
+    bool is_constant (int i) const { return m_values[i].op == WP_BC_CONST; }
+    amrex_real constant_value (int i) const { return m_values[i].v; }
+    int symbol (struct wp_node* node);
+    int binary (int op, int a, int b);
+    int negate (int a);
+
+    std::vector<std::string> const& m_varnames;
+    bool m_cse;
+    std::vector<wp_bc_value> m_values;
+    std::map<key_type,int> m_table;
+};
+
+int
+wp_bc_compiler::value (int op, int f, int a, int b, amrex_real v)
+{
+    unsigned long long bits = 0;
+    std::memcpy(&bits, &v, sizeof(amrex_real));
+    const key_type key(op, f, a, b, bits);
+    if (m_cse || op == WP_BC_CONST) {
+        auto found = m_table.find(key);
+        if (found != m_table.end()) return found->second;
+    }
+    m_values.push_back({op, f, a, b, v});
+    const int i = m_values.size() - 1;
+    m_table[key] = i;
+    return i;
+}
+
+int
+wp_bc_compiler::symbol (struct wp_node* node)
+{
+    if (node->type == WP_NUMBER) {
+        return constant(((struct wp_number*)node)->value);
+    }
+    char const* name = ((struct wp_symbol*)node)->name;
+    for (int i = 0; i < static_cast<int>(m_varnames.size()); ++i) {
+        if (m_varnames[i] == name) return i;
+    }
+    amrex::Abort(std::string("WarpXParser: unknown symbol ") + name);
+    return -1;
+}
+
+int
+wp_bc_compiler::binary (int op, int a, int b)
+{
+    if (is_constant(a) && is_constant(b))
+    {
+        const amrex_real va = constant_value(a);
+        const amrex_real vb = constant_value(b);
+        switch (op) {
+        case WP_BC_ADD: return constant(va + vb);
+        case WP_BC_SUB: return constant(va - vb);
+        case WP_BC_MUL: return constant(va * vb);
+        default:        return constant(va / vb);
+        }
+    }
+    else if (is_constant(a))
+    {
+        const amrex_real va = constant_value(a);
+        switch (op) {
+        case WP_BC_ADD: return value(WP_BC_ADD_V, 0, b, -1, va);
+        case WP_BC_SUB: return value(WP_BC_SUB_V, 0, b, -1, va);
+        case WP_BC_MUL: return value(WP_BC_MUL_V, 0, b, -1, va);
+        default:        return value(WP_BC_DIV_V, 0, b, -1, va);
+        }
+    }
+    else if (is_constant(b))
+    {
+        /* x+v and x*v are v+x and v*x: addition and multiplication
+         * are commutative in floating point */
+        const amrex_real vb = constant_value(b);
+        switch (op) {
+        case WP_BC_ADD: return value(WP_BC_ADD_V,  0, a, -1, vb);
+        case WP_BC_SUB: return value(WP_BC_SUB_RV, 0, a, -1, vb);
+        case WP_BC_MUL: return value(WP_BC_MUL_V,  0, a, -1, vb);
+        default:        return value(WP_BC_DIV_RV, 0, a, -1, vb);
+        }
+    }
+    else
+    {
+        if ((op == WP_BC_ADD || op == WP_BC_MUL) && b < a) std::swap(a, b);
+        return value(op, 0, a, b, 0.0);
+    }
+}
+
+int
+wp_bc_compiler::negate (int a)
+{
+    if (is_constant(a)) return constant(-constant_value(a));
+    return value(WP_BC_NEG, 0, a, -1, 0.0);
+}
+
+int
+wp_bc_compiler::compile (struct wp_node* node)
+{
+    switch (node->type)
+    {
+    case WP_NUMBER:
+    case WP_SYMBOL:
+        return symbol(node);
+    case WP_ADD:
+    case WP_ADD_PP:
+        return binary(WP_BC_ADD, compile(node->l), compile(node->r));
+    case WP_SUB:
+    case WP_SUB_PP:
+        return binary(WP_BC_SUB, compile(node->l), compile(node->r));
+    case WP_MUL:
+    case WP_MUL_PP:
+        return binary(WP_BC_MUL, compile(node->l), compile(node->r));
+    case WP_DIV:
+    case WP_DIV_PP:
+        return binary(WP_BC_DIV, compile(node->l), compile(node->r));
+    case WP_ADD_VP:
+        return binary(WP_BC_ADD, constant(node->lvp.v), compile(node->r));
+    case WP_SUB_VP:
+        return binary(WP_BC_SUB, constant(node->lvp.v), compile(node->r));
+    case WP_MUL_VP:
+        return binary(WP_BC_MUL, constant(node->lvp.v), compile(node->r));
+    case WP_DIV_VP:
+        return binary(WP_BC_DIV, constant(node->lvp.v), compile(node->r));
+    case WP_NEG:
+    case WP_NEG_P:
+        return negate(compile(node->l));
+    case WP_F1:
+    {
+        const enum wp_f1_t f = ((struct wp_f1*)node)->ftype;
+        const int a = compile(((struct wp_f1*)node)->l);
+        if (f == WP_POW_P1) return a;
+        if (is_constant(a)) return constant(wp_call_f1(f, constant_value(a)));
+        return value(WP_BC_F1, f, a, -1, 0.0);
+    }
+    case WP_F2:
+    {
+        const enum wp_f2_t f = ((struct wp_f2*)node)->ftype;
+        const int a = compile(((struct wp_f2*)node)->l);
+        const int b = compile(((struct wp_f2*)node)->r);
+        if (is_constant(a) && is_constant(b)) {
+            return constant(wp_call_f2(f, constant_value(a), constant_value(b)));
+        }
+        return value(WP_BC_F2, f, a, b, 0.0);
+    }
+    default:
+        amrex::Abort("wp_bytecode_compile: unknown node type " + std::to_string(node->type));
+        return -1;
+    }
+}
+
+/* Number of registers read by the instruction of a value */
+int
+wp_bc_noperands (int op)
+{
+    switch (op) {
+    case WP_BC_CONST:
+        return 0;
+    case WP_BC_ADD:
+    case WP_BC_SUB:
+    case WP_BC_MUL:
+    case WP_BC_DIV:
+    case WP_BC_F2:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+/* Emit the instructions of the values needed by value root, and assign
+ * registers to the values: the register of a value is released after
+ * its last use, and reused by the next values.
+ */
+struct wp_bytecode
+wp_bc_generate (std::vector<wp_bc_value> const& values, int nvars, int root,
+                std::vector<struct wp_bc_instr>& instrs)
+{
+    const int nvalues = values.size();
+
+    std::vector<char> needed(nvalues, 0);
+    std::vector<int> last_use(nvalues, -1);
+    needed[root] = 1;
+    last_use[root] = INT_MAX;
+    for (int i = nvalues-1; i >= nvars; --i) {
+        if (!needed[i]) continue;
+        const int nops = wp_bc_noperands(values[i].op);
+        if (nops > 0) {
+            needed[values[i].a] = 1;
+            last_use[values[i].a] = std::max(last_use[values[i].a], i);
+        }
+        if (nops > 1) {
+            needed[values[i].b] = 1;
+            last_use[values[i].b] = std::max(last_use[values[i].b], i);
+        }
+    }
+
+    std::vector<int> reg(nvalues, -1);
+    std::set<int> free_regs;
+    int nregs = nvars;
+    for (int i = 0; i < nvars; ++i) {
+        reg[i] = i;
+        if (!needed[i]) free_regs.insert(i);
+    }
+
+    instrs.clear();
+    for (int i = nvars; i < nvalues; ++i)
+    {
+        if (!needed[i]) continue;
+        const wp_bc_value& val = values[i];
+        const int nops = wp_bc_noperands(val.op);
+        struct wp_bc_instr in;
+        in.op = static_cast<enum wp_bc_op_t>(val.op);
+        in.f = val.f;
+        in.a = (nops > 0) ? reg[val.a] : 0;
+        in.b = (nops > 1) ? reg[val.b] : 0;
+        in.v = val.v;
+        if (nops > 0 && last_use[val.a] == i) free_regs.insert(reg[val.a]);
+        if (nops > 1 && last_use[val.b] == i) free_regs.insert(reg[val.b]);
+        if (free_regs.empty()) {
+            reg[i] = nregs++;
+        } else {
+            reg[i] = *free_regs.begin();
+            free_regs.erase(free_regs.begin());
+        }
+        in.dst = reg[i];
+        instrs.push_back(in);
+    }
+
+    struct wp_bytecode bc;
+    bc.nvars = nvars;
+    bc.nregs = nregs;
+    bc.ninstrs = instrs.size();
+    bc.result = reg[root];
+    bc.instrs = nullptr;
+    return bc;
+}
+
+}
+
+struct wp_bytecode
+wp_bytecode_compile (struct wp_node* ast, std::vector<std::string> const& varnames,
+                     std::vector<struct wp_bc_instr>& instrs)
+{
+    const int nvars = varnames.size();
+    struct wp_bytecode bc;
+    {
+        wp_bc_compiler compiler(varnames, true);
+        const int root = compiler.compile(ast);
+        bc = wp_bc_generate(compiler.values(), nvars, root, instrs);
+    }
+    if (bc.nregs > WP_BC_MAX_REGS) {
+        // Shared subexpressions keep their registers until their last
+        // use; try again without sharing them.
+        wp_bc_compiler compiler(varnames, false);
+        const int root = compiler.compile(ast);
+        bc = wp_bc_generate(compiler.values(), nvars, root, instrs);
+    }
+    if (bc.nregs > WP_BC_MAX_REGS) {
+        amrex::Abort("WarpXParser: the expression needs " + std::to_string(bc.nregs)
+                     + " registers, more than WP_BC_MAX_REGS ("
+                     + std::to_string(WP_BC_MAX_REGS) + ")");
+    }
+    return bc;
+}
@@ -0,0 +1,207 @@
+#ifndef WP_PARSER_BC_H_
+#define WP_PARSER_BC_H_
+
+#include "wp_parser_y.h"
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_Extension.H>
+#include <AMReX_REAL.H>
+
+#include <string>
+#include <vector>
+
+/* The AST of a parsed expression is compiled into a flat register
+ * bytecode: a list of instructions that read and write the slots of a
+ * register array.  The arguments of the expression are passed in the
+ * first registers, constants are folded or embedded in the instructions,
+ * and identical subexpressions are computed only once.  Every operation
+ * is the same floating point operation as in wp_ast_eval, so that the
+ * results of both are identical.
+ */
+
+/* Maximum number of registers of a compiled expression */
+#define WP_BC_MAX_REGS 64
+
+/* Number of points evaluated at once by wp_bytecode_eval_block */
+#define WP_BC_BLOCK 64
+
+enum wp_bc_op_t {
+    WP_BC_CONST = 1,  /* r[dst] = v             */
+    WP_BC_ADD,        /* r[dst] = r[a] + r[b]   */
+    WP_BC_SUB,        /* r[dst] = r[a] - r[b]   */
+    WP_BC_MUL,        /* r[dst] = r[a] * r[b]   */
+    WP_BC_DIV,        /* r[dst] = r[a] / r[b]   */
+    WP_BC_NEG,        /* r[dst] = -r[a]         */
+    WP_BC_ADD_V,      /* r[dst] = v + r[a]      */
+    WP_BC_SUB_V,      /* r[dst] = v - r[a]      */
+    WP_BC_MUL_V,      /* r[dst] = v * r[a]      */
+    WP_BC_DIV_V,      /* r[dst] = v / r[a]      */
+    WP_BC_SUB_RV,     /* r[dst] = r[a] - v      */
+    WP_BC_DIV_RV,     /* r[dst] = r[a] / v      */
+    WP_BC_F1,         /* r[dst] = f(r[a])       */
+    WP_BC_F2          /* r[dst] = f(r[a], r[b]) */
+};
+
+struct wp_bc_instr {
+    enum wp_bc_op_t op;
+    int f;            /* wp_f1_t or wp_f2_t for WP_BC_F1 and WP_BC_F2 */
+    int dst;
+    int a;
+    int b;
+    amrex_real v;
+};
+
+struct wp_bytecode {
+    int nvars;        /* the arguments are in registers [0,nvars) */
+    int nregs;
+    int ninstrs;
+    int result;       /* register of the result */
+    struct wp_bc_instr* instrs;
+};
+
+/* Compile the (optimized) AST of an expression of the variables
+ * varnames.  The instructions are returned in instrs, and the instrs
+ * member of the result is left to the caller to set.  Aborts if a symbol
+ * of the expression is not one of the variables, or if the expression
+ * needs more than WP_BC_MAX_REGS registers.
+ */
+struct wp_bytecode wp_bytecode_compile (struct wp_node* ast,
+                                        std::vector<std::string> const& varnames,
+                                        std::vector<struct wp_bc_instr>& instrs);
+
+/* Evaluate the bytecode with the registers r, whose first bc.nvars
+ * slots hold the arguments.
+ */
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+amrex_real
+wp_bytecode_eval (struct wp_bytecode const& bc, amrex_real* r) noexcept
+{
+    struct wp_bc_instr const* in = bc.instrs;
+    for (int n = 0; n < bc.ninstrs; ++n, ++in)
+    {
+        switch (in->op)
+        {
+        case WP_BC_CONST:  r[in->dst] = in->v;                break;
+        case WP_BC_ADD:    r[in->dst] = r[in->a] + r[in->b];  break;
+        case WP_BC_SUB:    r[in->dst] = r[in->a] - r[in->b];  break;
+        case WP_BC_MUL:    r[in->dst] = r[in->a] * r[in->b];  break;
+        case WP_BC_DIV:    r[in->dst] = r[in->a] / r[in->b];  break;
+        case WP_BC_NEG:    r[in->dst] = -r[in->a];            break;
+        case WP_BC_ADD_V:  r[in->dst] = in->v + r[in->a];     break;
+        case WP_BC_SUB_V:  r[in->dst] = in->v - r[in->a];     break;
+        case WP_BC_MUL_V:  r[in->dst] = in->v * r[in->a];     break;
+        case WP_BC_DIV_V:  r[in->dst] = in->v / r[in->a];     break;
+        case WP_BC_SUB_RV: r[in->dst] = r[in->a] - in->v;     break;
+        case WP_BC_DIV_RV: r[in->dst] = r[in->a] / in->v;     break;
+        case WP_BC_F1:
+            r[in->dst] = wp_call_f1((enum wp_f1_t)in->f, r[in->a]);
+            break;
+        case WP_BC_F2:
+            r[in->dst] = wp_call_f2((enum wp_f2_t)in->f, r[in->a], r[in->b]);
+            break;
+        }
+    }
+    return r[bc.result];
+}
+
+/* Evaluate the bytecode for n <= WP_BC_BLOCK points.  Register k of
+ * point i is r[k*WP_BC_BLOCK+i]: the caller fills the registers of the
+ * arguments, and reads the result in the registers bc.result.  Each
+ * instruction is applied to all the points before the next one, so that
+ * the arithmetic vectorizes.
+ */
+inline
+void
+wp_bytecode_eval_block (struct wp_bytecode const& bc, amrex_real* r, int n) noexcept
+{
+    struct wp_bc_instr const* in = bc.instrs;
+    for (int m = 0; m < bc.ninstrs; ++m, ++in)
+    {
+        amrex_real* d = r + in->dst*WP_BC_BLOCK;
+        amrex_real const* a = r + in->a*WP_BC_BLOCK;
+        amrex_real const* b = r + in->b*WP_BC_BLOCK;
+        amrex_real const v = in->v;
+        switch (in->op)
+        {
+        case WP_BC_CONST:
+            for (int i = 0; i < n; ++i) d[i] = v;
+            break;
+        case WP_BC_ADD:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] + b[i];
+            break;
+        case WP_BC_SUB:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] - b[i];
+            break;
+        case WP_BC_MUL:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] * b[i];
+            break;
+        case WP_BC_DIV:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] / b[i];
+            break;
+        case WP_BC_NEG:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = -a[i];
+            break;
+        case WP_BC_ADD_V:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = v + a[i];
+            break;
+        case WP_BC_SUB_V:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = v - a[i];
+            break;
+        case WP_BC_MUL_V:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = v * a[i];
+            break;
+        case WP_BC_DIV_V:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = v / a[i];
+            break;
+        case WP_BC_SUB_RV:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] - v;
+            break;
+        case WP_BC_DIV_RV:
+            AMREX_PRAGMA_SIMD
+            for (int i = 0; i < n; ++i) d[i] = a[i] / v;
+            break;
+        case WP_BC_F1:
+            /* the cheap functions are inlined, as written in wp_call_f1 */
+            switch (in->f)
+            {
+            case WP_POW_M3:
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < n; ++i) d[i] = 1.0/(a[i]*a[i]*a[i]);
+                break;
+            case WP_POW_M2:
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < n; ++i) d[i] = 1.0/(a[i]*a[i]);
+                break;
+            case WP_POW_M1:
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < n; ++i) d[i] = 1.0/a[i];
+                break;
+            case WP_POW_P2:
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < n; ++i) d[i] = a[i]*a[i];
+                break;
+            case WP_POW_P3:
+                AMREX_PRAGMA_SIMD
+                for (int i = 0; i < n; ++i) d[i] = a[i]*a[i]*a[i];
+                break;
+            default:
+                for (int i = 0; i < n; ++i) d[i] = wp_call_f1((enum wp_f1_t)in->f, a[i]);
+            }
+            break;
+        case WP_BC_F2:
+            for (int i = 0; i < n; ++i) d[i] = wp_call_f2((enum wp_f2_t)in->f, a[i], b[i]);
+            break;
+        }
+    }
+}
+
+#endif
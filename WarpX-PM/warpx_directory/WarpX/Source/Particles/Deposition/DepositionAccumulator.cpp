@@ -0,0 +1,218 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "DepositionAccumulator.H"
+#include "WarpX.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX_BoxList.H>
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_Loop.H>
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace
+{
+    /** \brief Index, along one direction, of the tile that starts at offset
+     * cells from the lower end of a box of ncells cells. This follows the
+     * tiling of FabArrayBase::buildTileArray.
+     */
+    int TileIndexInDir (int offset, int ncells, int tile_size)
+    {
+        const int nt = (tile_size > 0) ? std::max(ncells/tile_size, 1) : 1;
+        const int tsize = ncells/nt;
+        const int nleft = ncells - nt*tsize;
+        if (offset < nleft*(tsize+1)) {
+            return offset/(tsize+1);
+        } else {
+            return nleft + (offset - nleft*(tsize+1))/tsize;
+        }
+    }
+}
+
+void
+DepositionAccumulator::SetNumThreads (int nthreads)
+{
+    if (m_buffers.size() < static_cast<std::size_t>(nthreads)) {
+        m_buffers.resize(nthreads);
+        for (auto& thread_buffers : m_buffers) thread_buffers.resize(nbuffers);
+    }
+}
+
+void
+DepositionAccumulator::BeginTileLoop (int ntiles, const IntVect& tile_size)
+{
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_in_tile_loop,
+        "DepositionAccumulator: AddHalos must be called at the end of each tile loop");
+    if (m_tile_halos.size() < static_cast<std::size_t>(ntiles)) {
+        m_tile_halos.resize(ntiles);
+    }
+    m_tile_size = tile_size;
+    m_in_tile_loop = true;
+}
+
+Real*
+DepositionAccumulator::GetBuffer (int thread_num, int ibuf, const Box& bx, int ncomp)
+{
+    // The buffer is only ever grown (with zeros), and Accumulate resets
+    // what it reads, so that the whole buffer is zero here.
+    auto& buffer = m_buffers[thread_num][ibuf];
+    const std::size_t n = bx.numPts()*ncomp;
+    if (buffer.size() < n) buffer.resize(n, 0.0_rt);
+    return buffer.dataPtr();
+}
+
+void
+DepositionAccumulator::Accumulate (FArrayBox& buf, FArrayBox& dst, int dcomp,
+                                   const Box& tilebox, const Box& validbox,
+                                   int tile_index)
+{
+    const Box& bbx = buf.box();
+    const int ncomp = buf.nComp();
+    Array4<Real> const& b = buf.array();
+    Array4<Real> const& d = dst.array();
+    AMREX_ASSERT(dst.box().contains(bbx));
+
+    if (!m_in_tile_loop || tile_index < 0) {
+        LoopOnCpu(bbx, ncomp, [=] (int i, int j, int k, int n) noexcept
+        {
+            HostDevice::Atomic::Add(d.ptr(i,j,k,n+dcomp), b(i,j,k,n));
+            b(i,j,k,n) = 0.0_rt;
+        });
+        return;
+    }
+
+    // Interior of the tile: in nodal directions, the last node belongs to
+    // the next tile, unless the tile is at the upper end of the valid box.
+    Box interior = convert(tilebox, bbx.ixType());
+    for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+        if (bbx.type(idim) == IndexType::NODE && tilebox.bigEnd(idim) != validbox.bigEnd(idim)) {
+            interior.growHi(idim, -1);
+        }
+    }
+    AMREX_ASSERT(bbx.contains(interior));
+
+    // Phase one: the interiors of the tiles of a box do not overlap
+    LoopConcurrentOnCpu(interior, ncomp, [=] (int i, int j, int k, int n) noexcept
+    {
+        d(i,j,k,n+dcomp) += b(i,j,k,n);
+        b(i,j,k,n) = 0.0_rt;
+    });
+
+    // Color of the tile, and whether the halos of the tiles of this color
+    // are disjoint. The halos of tiles i and i+2 in a direction are disjoint
+    // if tile i+1 is at least as long as the two halo widths; as the tiles
+    // of a box differ by at most one cell, this tile must be one cell longer.
+    TileHalos& tile_halos = m_tile_halos[tile_index];
+    int color = 0;
+    bool atomic = false;
+    for (int idim=0; idim<AMREX_SPACEDIM; idim++) {
+        const int ncells = validbox.length(idim);
+        const int offset = tilebox.smallEnd(idim) - validbox.smallEnd(idim);
+        const int itile = TileIndexInDir(offset, ncells, m_tile_size[idim]);
+        color += (itile%2) << idim;
+        const int halo_width = (tilebox.smallEnd(idim) - bbx.smallEnd(idim))
+                             + (bbx.bigEnd(idim) - tilebox.bigEnd(idim));
+        if (tilebox.length(idim) < ncells && tilebox.length(idim) < halo_width + 1) {
+            atomic = true;
+        }
+    }
+    tile_halos.color = color;
+
+    // Store the halo, to be added in phase two
+    if (tile_halos.nentries == static_cast<int>(tile_halos.entries.size())) {
+        tile_halos.entries.resize(tile_halos.nentries + 1);
+    }
+    HaloEntry& entry = tile_halos.entries[tile_halos.nentries++];
+    entry.dst = &dst;
+    entry.dcomp = dcomp;
+    entry.ncomp = ncomp;
+    entry.atomic = atomic;
+    entry.boxes.clear();
+    long npts = 0;
+    for (const Box& hbx : boxDiff(bbx, interior)) {
+        entry.boxes.push_back(hbx);
+        npts += hbx.numPts();
+    }
+    entry.data.resize(npts*ncomp);
+    Real* AMREX_RESTRICT p = entry.data.dataPtr();
+    for (const Box& hbx : entry.boxes) {
+        const Dim3 lo = lbound(hbx);
+        const Dim3 hi = ubound(hbx);
+        for (int n = 0; n < ncomp; ++n) {
+        for (int k = lo.z; k <= hi.z; ++k) {
+        for (int j = lo.y; j <= hi.y; ++j) {
+            AMREX_PRAGMA_SIMD
+            for (int i = lo.x; i <= hi.x; ++i) {
+                p[i-lo.x] = b(i,j,k,n);
+                b(i,j,k,n) = 0.0_rt;
+            }
+            p += hi.x - lo.x + 1;
+        }
+        }
+        }
+    }
+}
+
+void
+DepositionAccumulator::AddHalos ()
+{
+    WARPX_PROFILE("DepositionAccumulator::AddHalos()");
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_in_tile_loop,
+        "DepositionAccumulator: AddHalos called outside of a tile loop");
+    m_in_tile_loop = false;
+
+    const int ntiles = m_tile_halos.size();
+    constexpr int ncolors = 1 << AMREX_SPACEDIM;
+
+    // Phase two: the halos of the tiles of one color do not overlap (or
+    // are added atomically), and the colors are separated by the implicit
+    // barrier at the end of the omp for loop.
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (int color = 0; color < ncolors; ++color) {
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int itile = 0; itile < ntiles; ++itile) {
+            TileHalos& tile_halos = m_tile_halos[itile];
+            if (tile_halos.nentries == 0 || tile_halos.color != color) continue;
+
+            for (int ie = 0; ie < tile_halos.nentries; ++ie) {
+                const HaloEntry& entry = tile_halos.entries[ie];
+                Array4<Real> const& d = entry.dst->array();
+                const int dcomp = entry.dcomp;
+                const Real* AMREX_RESTRICT p = entry.data.dataPtr();
+                for (const Box& hbx : entry.boxes) {
+                    const Dim3 lo = lbound(hbx);
+                    const Dim3 hi = ubound(hbx);
+                    for (int n = 0; n < entry.ncomp; ++n) {
+                    for (int k = lo.z; k <= hi.z; ++k) {
+                    for (int j = lo.y; j <= hi.y; ++j) {
+                        if (entry.atomic) {
+                            for (int i = lo.x; i <= hi.x; ++i) {
+                                HostDevice::Atomic::Add(d.ptr(i,j,k,n+dcomp), p[i-lo.x]);
+                            }
+                        } else {
+                            AMREX_PRAGMA_SIMD
+                            for (int i = lo.x; i <= hi.x; ++i) {
+                                d(i,j,k,n+dcomp) += p[i-lo.x];
+                            }
+                        }
+                        p += hi.x - lo.x + 1;
+                    }
+                    }
+                    }
+                }
+            }
+            tile_halos.nentries = 0;
+        }
+    }
+}
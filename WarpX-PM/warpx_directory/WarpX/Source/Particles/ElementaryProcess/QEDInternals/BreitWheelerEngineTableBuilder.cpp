@@ -5,6 +5,14 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "BreitWheelerEngineTableBuilder.H"
+#include "QedTableGenHelperFunctions.H"
+
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
 
 //Include the full Breit Wheeler engine with table generation support
 //(after some consistency tests). This requires to have a recent version
@@ -32,33 +40,100 @@ BreitWheelerEngineTableBuilder::compute_table
     (PicsarBreitWheelerCtrl ctrl,
      BreitWheelerEngineInnards& innards) const
 {
-    PicsarBreitWheelerEngine bw_engine(
-        std::move(QedUtils::DummyStruct()), 1.0, ctrl);
+    using namespace picsar::multi_physics;
+
+    //Each rank computes a range of rows of the tables with an engine
+    //restricted to these values of chi. The rows are then gathered.
+
+    //--- sub-table 1 (1D)
+    const int dndt_how_many = ctrl.chi_phot_tdndt_how_many;
+    const auto dndt_chi = generate_log_spaced_vec(ctrl.chi_phot_tdndt_min,
+        ctrl.chi_phot_tdndt_max, ctrl.chi_phot_tdndt_how_many);
+    const auto dndt_rows = QedUtils::local_table_rows(dndt_how_many);
+    amrex::Vector<amrex::Real> dndt_data(dndt_rows.second - dndt_rows.first);
+
+    //The rows of the rank are further split among the threads
+#ifdef _OPENMP
+    const int nchunks = omp_get_max_threads();
+#else
+    const int nchunks = 1;
+#endif
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ichunk = 0; ichunk < nchunks; ++ichunk){
+        const auto rows = QedUtils::split_rows(
+            dndt_rows.first, dndt_rows.second, ichunk, nchunks);
+        if (rows.first == rows.second) continue;
+        const auto padded = QedUtils::padded_rows(
+            rows.first, rows.second, dndt_how_many);
+
+        auto sub_ctrl = ctrl;
+        sub_ctrl.chi_phot_tdndt_min = dndt_chi[padded.first];
+        sub_ctrl.chi_phot_tdndt_max = dndt_chi[padded.second-1];
+        sub_ctrl.chi_phot_tdndt_how_many = padded.second - padded.first;
+
+        PicsarBreitWheelerEngine bw_engine(
+            std::move(QedUtils::DummyStruct()), 1.0, sub_ctrl);
+        bw_engine.compute_dN_dt_lookup_table();
+        auto bw_innards_picsar = bw_engine.export_innards();
+
+        std::copy(bw_innards_picsar.TTfunc_table_data_ptr + (rows.first - padded.first),
+            bw_innards_picsar.TTfunc_table_data_ptr + (rows.second - padded.first),
+            dndt_data.begin() + (rows.first - dndt_rows.first));
+    }
+    //------
+
+    //--- sub-table 2 (2D)
+    //The engine already splits the rows among the threads
+    const int pair_how_many = ctrl.chi_phot_tpair_how_many;
+    const int frac_how_many = ctrl.chi_frac_tpair_how_many;
+    const auto pair_chi = generate_log_spaced_vec(ctrl.chi_phot_tpair_min,
+        ctrl.chi_phot_tpair_max, ctrl.chi_phot_tpair_how_many);
+    const auto pair_rows = QedUtils::local_table_rows(pair_how_many);
+    amrex::Vector<amrex::Real> pair_data(
+        static_cast<long>(pair_rows.second - pair_rows.first)*frac_how_many);
+
+    if (pair_rows.first != pair_rows.second){
+        const auto padded = QedUtils::padded_rows(
+            pair_rows.first, pair_rows.second, pair_how_many);
+
+        auto sub_ctrl = ctrl;
+        sub_ctrl.chi_phot_tpair_min = pair_chi[padded.first];
+        sub_ctrl.chi_phot_tpair_max = pair_chi[padded.second-1];
+        sub_ctrl.chi_phot_tpair_how_many = padded.second - padded.first;
 
-    bw_engine.compute_dN_dt_lookup_table();
-    bw_engine.compute_cumulative_pair_table();
+        PicsarBreitWheelerEngine bw_engine(
+            std::move(QedUtils::DummyStruct()), 1.0, sub_ctrl);
+        bw_engine.compute_cumulative_pair_table();
+        auto bw_innards_picsar = bw_engine.export_innards();
 
-    auto bw_innards_picsar = bw_engine.export_innards();
+        std::copy(bw_innards_picsar.cum_distrib_table_data_ptr +
+            static_cast<long>(pair_rows.first - padded.first)*frac_how_many,
+            bw_innards_picsar.cum_distrib_table_data_ptr +
+            static_cast<long>(pair_rows.second - padded.first)*frac_how_many,
+            pair_data.begin());
+    }
+    //------
 
     //Copy data in a GPU-friendly data-structure
-    innards.ctrl = bw_innards_picsar.bw_ctrl;
-    innards.TTfunc_coords.assign(bw_innards_picsar.TTfunc_table_coords_ptr,
-        bw_innards_picsar.TTfunc_table_coords_ptr +
-        bw_innards_picsar.TTfunc_table_coords_how_many);
-    innards.TTfunc_data.assign(bw_innards_picsar.TTfunc_table_data_ptr,
-        bw_innards_picsar.TTfunc_table_data_ptr +
-        bw_innards_picsar.TTfunc_table_data_how_many);
-    innards.cum_distrib_coords_1.assign(
-        bw_innards_picsar.cum_distrib_table_coords_1_ptr,
-        bw_innards_picsar.cum_distrib_table_coords_1_ptr +
-        bw_innards_picsar.cum_distrib_table_coords_1_how_many);
-    innards.cum_distrib_coords_2.assign(
-        bw_innards_picsar.cum_distrib_table_coords_2_ptr,
-        bw_innards_picsar.cum_distrib_table_coords_2_ptr +
-        bw_innards_picsar.cum_distrib_table_coords_2_how_many);
-    innards.cum_distrib_data.assign(
-        bw_innards_picsar.cum_distrib_table_data_ptr,
-        bw_innards_picsar.cum_distrib_table_data_ptr +
-        bw_innards_picsar.cum_distrib_table_data_how_many);
+    //(the tables store the logarithms of chi and of the data)
+    auto logfun = [](amrex::Real val){return std::log(val);};
+    innards.ctrl = ctrl;
+    amrex::Vector<amrex::Real> log_chi(dndt_chi.size());
+    std::transform(dndt_chi.begin(), dndt_chi.end(), log_chi.begin(), logfun);
+    innards.TTfunc_coords.assign(log_chi.begin(), log_chi.end());
+    const auto all_dndt_data = QedUtils::all_gather_table_rows(
+        dndt_data, dndt_how_many, 1);
+    innards.TTfunc_data.assign(all_dndt_data.begin(), all_dndt_data.end());
+    log_chi.resize(pair_chi.size());
+    std::transform(pair_chi.begin(), pair_chi.end(), log_chi.begin(), logfun);
+    innards.cum_distrib_coords_1.assign(log_chi.begin(), log_chi.end());
+    const auto frac_coords = generate_lin_spaced_vec(
+        amrex::Real(0.0), amrex::Real(0.5), ctrl.chi_frac_tpair_how_many);
+    innards.cum_distrib_coords_2.assign(frac_coords.begin(), frac_coords.end());
+    const auto all_pair_data = QedUtils::all_gather_table_rows(
+        pair_data, pair_how_many, frac_how_many);
+    innards.cum_distrib_data.assign(all_pair_data.begin(), all_pair_data.end());
     //____
 }
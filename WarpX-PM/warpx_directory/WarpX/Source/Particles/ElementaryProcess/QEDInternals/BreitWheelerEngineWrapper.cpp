@@ -169,6 +169,20 @@ void BreitWheelerEngine::init_dummy_tables()
     m_lookup_tables_initialized = true;
 }
 
+Vector<char> BreitWheelerEngine::export_ctrl_data (const PicsarBreitWheelerCtrl& ctrl)
+{
+    Vector<char> res{};
+    add_data_to_vector_char(&ctrl.chi_phot_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tdndt_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_phot_tpair_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_frac_tpair_how_many, 1, res);
+    return res;
+}
+
 Vector<char> BreitWheelerEngine::export_lookup_tables_data () const
 {
    Vector<char> res{};
@@ -176,14 +190,7 @@ Vector<char> BreitWheelerEngine::export_lookup_tables_data () const
     if(!m_lookup_tables_initialized)
         return res;
 
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tdndt_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_phot_tpair_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_frac_tpair_how_many, 1, res);
+    res = export_ctrl_data(m_innards.ctrl);
 
     add_data_to_vector_char(m_innards.TTfunc_coords.data(),
         m_innards.TTfunc_coords.size(), res);
@@ -5,6 +5,14 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "QuantumSyncEngineTableBuilder.H"
+#include "QedTableGenHelperFunctions.H"
+
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
 
 //Include the full Quantum Synchrotron engine with table generation support
 //(after some consistency tests). This requires to have a recent version
@@ -32,33 +40,100 @@ QuantumSynchrotronEngineTableBuilder::compute_table
     (PicsarQuantumSynchrotronCtrl ctrl,
      QuantumSynchrotronEngineInnards& innards) const
 {
-    PicsarQuantumSynchrotronEngine qs_engine(
-        std::move(QedUtils::DummyStruct()), 1.0, ctrl);
+    using namespace picsar::multi_physics;
+
+    //Each rank computes a range of rows of the tables with an engine
+    //restricted to these values of chi. The rows are then gathered.
+
+    //--- sub-table 1 (1D)
+    const int dndt_how_many = ctrl.chi_part_tdndt_how_many;
+    const auto dndt_chi = generate_log_spaced_vec(ctrl.chi_part_tdndt_min,
+        ctrl.chi_part_tdndt_max, ctrl.chi_part_tdndt_how_many);
+    const auto dndt_rows = QedUtils::local_table_rows(dndt_how_many);
+    amrex::Vector<amrex::Real> dndt_data(dndt_rows.second - dndt_rows.first);
+
+    //The rows of the rank are further split among the threads
+#ifdef _OPENMP
+    const int nchunks = omp_get_max_threads();
+#else
+    const int nchunks = 1;
+#endif
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ichunk = 0; ichunk < nchunks; ++ichunk){
+        const auto rows = QedUtils::split_rows(
+            dndt_rows.first, dndt_rows.second, ichunk, nchunks);
+        if (rows.first == rows.second) continue;
+        const auto padded = QedUtils::padded_rows(
+            rows.first, rows.second, dndt_how_many);
+
+        auto sub_ctrl = ctrl;
+        sub_ctrl.chi_part_tdndt_min = dndt_chi[padded.first];
+        sub_ctrl.chi_part_tdndt_max = dndt_chi[padded.second-1];
+        sub_ctrl.chi_part_tdndt_how_many = padded.second - padded.first;
+
+        PicsarQuantumSynchrotronEngine qs_engine(
+            std::move(QedUtils::DummyStruct()), 1.0, sub_ctrl);
+        qs_engine.compute_dN_dt_lookup_table();
+        auto qs_innards_picsar = qs_engine.export_innards();
+
+        std::copy(qs_innards_picsar.KKfunc_table_data_ptr + (rows.first - padded.first),
+            qs_innards_picsar.KKfunc_table_data_ptr + (rows.second - padded.first),
+            dndt_data.begin() + (rows.first - dndt_rows.first));
+    }
+    //------
+
+    //--- sub-table 2 (2D)
+    //The engine already splits the rows among the threads
+    const int em_how_many = ctrl.chi_part_tem_how_many;
+    const int prob_how_many = ctrl.prob_tem_how_many;
+    const auto em_chi = generate_log_spaced_vec(ctrl.chi_part_tem_min,
+        ctrl.chi_part_tem_max, ctrl.chi_part_tem_how_many);
+    const auto em_rows = QedUtils::local_table_rows(em_how_many);
+    amrex::Vector<amrex::Real> em_data(
+        static_cast<long>(em_rows.second - em_rows.first)*prob_how_many);
+
+    if (em_rows.first != em_rows.second){
+        const auto padded = QedUtils::padded_rows(
+            em_rows.first, em_rows.second, em_how_many);
+
+        auto sub_ctrl = ctrl;
+        sub_ctrl.chi_part_tem_min = em_chi[padded.first];
+        sub_ctrl.chi_part_tem_max = em_chi[padded.second-1];
+        sub_ctrl.chi_part_tem_how_many = padded.second - padded.first;
 
-    qs_engine.compute_dN_dt_lookup_table();
-    qs_engine.compute_cumulative_phot_em_table();
+        PicsarQuantumSynchrotronEngine qs_engine(
+            std::move(QedUtils::DummyStruct()), 1.0, sub_ctrl);
+        qs_engine.compute_cumulative_phot_em_table();
+        auto qs_innards_picsar = qs_engine.export_innards();
 
-    auto qs_innards_picsar = qs_engine.export_innards();
+        std::copy(qs_innards_picsar.cum_distrib_table_data_ptr +
+            static_cast<long>(em_rows.first - padded.first)*prob_how_many,
+            qs_innards_picsar.cum_distrib_table_data_ptr +
+            static_cast<long>(em_rows.second - padded.first)*prob_how_many,
+            em_data.begin());
+    }
+    //------
 
     //Copy data in a GPU-friendly data-structure
-    innards.ctrl = qs_innards_picsar.qs_ctrl;
-    innards.KKfunc_coords.assign(qs_innards_picsar.KKfunc_table_coords_ptr,
-        qs_innards_picsar.KKfunc_table_coords_ptr +
-        qs_innards_picsar.KKfunc_table_coords_how_many);
-    innards.KKfunc_data.assign(qs_innards_picsar.KKfunc_table_data_ptr,
-        qs_innards_picsar.KKfunc_table_data_ptr +
-        qs_innards_picsar.KKfunc_table_data_how_many);
-        innards.cum_distrib_coords_1.assign(
-    qs_innards_picsar.cum_distrib_table_coords_1_ptr,
-        qs_innards_picsar.cum_distrib_table_coords_1_ptr +
-        qs_innards_picsar.cum_distrib_table_coords_1_how_many);
-    innards.cum_distrib_coords_2.assign(
-        qs_innards_picsar.cum_distrib_table_coords_2_ptr,
-        qs_innards_picsar.cum_distrib_table_coords_2_ptr +
-        qs_innards_picsar.cum_distrib_table_coords_2_how_many);
-    innards.cum_distrib_data.assign(
-        qs_innards_picsar.cum_distrib_table_data_ptr,
-        qs_innards_picsar.cum_distrib_table_data_ptr +
-        qs_innards_picsar.cum_distrib_table_data_how_many);
+    //(the tables store the logarithms of chi and of the data)
+    auto logfun = [](amrex::Real val){return std::log(val);};
+    innards.ctrl = ctrl;
+    amrex::Vector<amrex::Real> log_chi(dndt_chi.size());
+    std::transform(dndt_chi.begin(), dndt_chi.end(), log_chi.begin(), logfun);
+    innards.KKfunc_coords.assign(log_chi.begin(), log_chi.end());
+    const auto all_dndt_data = QedUtils::all_gather_table_rows(
+        dndt_data, dndt_how_many, 1);
+    innards.KKfunc_data.assign(all_dndt_data.begin(), all_dndt_data.end());
+    log_chi.resize(em_chi.size());
+    std::transform(em_chi.begin(), em_chi.end(), log_chi.begin(), logfun);
+    innards.cum_distrib_coords_1.assign(log_chi.begin(), log_chi.end());
+    const auto prob_coords = generate_lin_spaced_vec(
+        amrex::Real(0.0), amrex::Real(1.0), ctrl.prob_tem_how_many);
+    innards.cum_distrib_coords_2.assign(prob_coords.begin(), prob_coords.end());
+    const auto all_em_data = QedUtils::all_gather_table_rows(
+        em_data, em_how_many, prob_how_many);
+    innards.cum_distrib_data.assign(all_em_data.begin(), all_em_data.end());
     //____
 }
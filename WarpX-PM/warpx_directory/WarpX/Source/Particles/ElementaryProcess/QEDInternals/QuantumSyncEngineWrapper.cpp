@@ -168,6 +168,20 @@ void QuantumSynchrotronEngine::init_dummy_tables()
     m_lookup_tables_initialized = true;
 }
 
+Vector<char> QuantumSynchrotronEngine::export_ctrl_data (const PicsarQuantumSynchrotronCtrl& ctrl)
+{
+    Vector<char> res{};
+    add_data_to_vector_char(&ctrl.chi_part_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tdndt_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_min, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_max, 1, res);
+    add_data_to_vector_char(&ctrl.chi_part_tem_how_many, 1, res);
+    add_data_to_vector_char(&ctrl.prob_tem_how_many, 1, res);
+    return res;
+}
+
 Vector<char> QuantumSynchrotronEngine::export_lookup_tables_data () const
 {
     Vector<char> res{};
@@ -175,14 +189,7 @@ Vector<char> QuantumSynchrotronEngine::export_lookup_tables_data () const
     if(!m_lookup_tables_initialized)
         return res;
 
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tdndt_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_min, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_max, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.chi_part_tem_how_many, 1, res);
-    add_data_to_vector_char(&m_innards.ctrl.prob_tem_how_many, 1, res);
+    res = export_ctrl_data(m_innards.ctrl);
 
     add_data_to_vector_char(m_innards.KKfunc_coords.data(),
         m_innards.KKfunc_coords.size(), res);
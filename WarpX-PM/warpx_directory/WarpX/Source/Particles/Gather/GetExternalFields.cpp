@@ -0,0 +1,52 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "GetExternalFields.H"
+#include "WarpX.H"
+
+GetExternalEField::GetExternalEField (const WarpXParIter& a_pti, int a_offset) noexcept
+    : GetExternalField(a_pti, a_offset)
+{
+    auto& warpx = WarpX::GetInstance();
+    auto& mypc = warpx.GetPartContainer();
+    if (mypc.m_E_ext_particle_s=="parse_e_ext_particle_function")
+    {
+        m_type = Parser;
+        m_time = warpx.gett_new(a_pti.GetLevel());
+        m_xfield_partparser = mypc.m_Ex_particle_parser.get();
+        m_yfield_partparser = mypc.m_Ey_particle_parser.get();
+        m_zfield_partparser = mypc.m_Ez_particle_parser.get();
+    }
+    else
+    {
+        m_type = Constant;
+        m_field_value[0] = mypc.m_E_external_particle[0];
+        m_field_value[1] = mypc.m_E_external_particle[1];
+        m_field_value[2] = mypc.m_E_external_particle[2];
+    }
+}
+
+GetExternalBField::GetExternalBField (const WarpXParIter& a_pti, int a_offset) noexcept
+    : GetExternalField(a_pti, a_offset)
+{
+    auto& warpx = WarpX::GetInstance();
+    auto& mypc = warpx.GetPartContainer();
+    if (mypc.m_B_ext_particle_s=="parse_b_ext_particle_function")
+    {
+        m_type = Parser;
+        m_time = warpx.gett_new(a_pti.GetLevel());
+        m_xfield_partparser = mypc.m_Bx_particle_parser.get();
+        m_yfield_partparser = mypc.m_By_particle_parser.get();
+        m_zfield_partparser = mypc.m_Bz_particle_parser.get();
+    }
+    else
+    {
+        m_type = Constant;
+        m_field_value[0] = mypc.m_B_external_particle[0];
+        m_field_value[1] = mypc.m_B_external_particle[1];
+        m_field_value[2] = mypc.m_B_external_particle[2];
+    }
+}
@@ -11,10 +11,17 @@
 #include "MultiParticleContainer.H"
 #include "SpeciesPhysicalProperties.H"
 #include "Utils/WarpXUtil.H"
+#include "Utils/WarpXRandom.H"
 #include "WarpX.H"
 
+#ifdef WARPX_QED
+#   include "Particles/ElementaryProcess/QEDInternals/QedTableParserHelperFunctions.H"
+#endif
+
+#include <AMReX_Utility.H>
 #include <AMReX_Vector.H>
 
+#include <cstdio>
 #include <limits>
 #include <algorithm>
 #include <string>
@@ -46,8 +53,6 @@ MultiParticleContainer::MultiParticleContainer (AmrCore* amr_core)
         allcontainers[i].reset(new LaserParticleContainer(amr_core, i, lasers_names[i-nspecies]));
     }
 
-    pc_tmp.reset(new PhysicalParticleContainer(amr_core));
-
     // Compute the number of species for which lab-frame data is dumped
     // nspecies_lab_frame_diags, and map their ID to MultiParticleContainer
     // particle IDs in map_species_lab_diags.
@@ -268,7 +273,6 @@ MultiParticleContainer::AllocData ()
     for (auto& pc : allcontainers) {
         pc->AllocData();
     }
-    pc_tmp->AllocData();
 }
 
 void
@@ -277,7 +281,6 @@ MultiParticleContainer::InitData ()
     for (auto& pc : allcontainers) {
         pc->InitData();
     }
-    pc_tmp->InitData();
     // For each species, get the ID of its product species.
     // This is used for ionization and pair creation processes.
     mapSpeciesProduct();
@@ -429,7 +432,6 @@ MultiParticleContainer::PostRestart ()
     for (auto& pc : allcontainers) {
         pc->PostRestart();
     }
-    pc_tmp->PostRestart();
 }
 
 void
@@ -621,7 +623,10 @@ MultiParticleContainer::doFieldIonization ()
         auto phys_pc_ptr = static_cast<PhysicalParticleContainer*>(pc_source.get());
 
         auto Filter    = phys_pc_ptr->getIonizationFunc();
-        auto Copy      = copy_factory.getSmartCopy();
+        const int step = WarpX::GetInstance().getistep(0);
+        auto Copy      = copy_factory.getSmartCopy(
+            RandomStream(RandomPurpose::ParticleCreation, step,
+                         pc_product->getSpeciesId(), pc_source->getSpeciesId()));
         auto Transform = IonizationTransformFunc();
 
         pc_source ->defineAllParticleTiles();
@@ -649,6 +654,24 @@ MultiParticleContainer::doFieldIonization ()
     }
 }
 
+void
+MultiParticleContainer::doParticleMerging ()
+{
+    WARPX_PROFILE("MPC::doParticleMerging");
+
+    const int step = WarpX::GetInstance().getistep(0);
+    for (auto& pc : allcontainers)
+    {
+        if (!pc->do_merging || step % pc->merging_int != 0){ continue; }
+
+        auto phys_pc_ptr = static_cast<PhysicalParticleContainer*>(pc.get());
+        for (int lev = 0; lev <= pc->finestLevel(); ++lev)
+        {
+            phys_pc_ptr->MergeParticles(lev);
+        }
+    }
+}
+
 void
 MultiParticleContainer::doCoulombCollisions ()
 {
@@ -819,6 +842,60 @@ void MultiParticleContainer::InitBreitWheeler ()
     }
 }
 
+namespace
+{
+    /**
+     * Initializes the lookup tables of engine from the cache, if it holds
+     * the tables of the control parameters ctrl, or computes them on all
+     * the ranks and saves them in the cache. The tables are also written
+     * to table_name.
+     */
+    template <class Engine, class Ctrl>
+    void GenerateOrLoadTable (Engine& engine, const Ctrl& ctrl,
+                              const std::string& table_name,
+                              const std::string& cache_dir,
+                              const std::string& prefix)
+    {
+        const Vector<char> ctrl_data = Engine::export_ctrl_data(ctrl);
+
+        std::string cache_name;
+        if(!cache_dir.empty()){
+            cache_name = cache_dir + "/" + prefix + QedUtils::hash_raw_data(ctrl_data);
+            Vector<char> table_data;
+            ParallelDescriptor::ReadAndBcastFile(cache_name, table_data, false);
+            // The exported tables start with the control parameters
+            if(table_data.size() > ctrl_data.size() &&
+               std::equal(ctrl_data.begin(), ctrl_data.end(), table_data.begin()) &&
+               engine.init_lookup_tables_from_raw_data(table_data)){
+                amrex::Print() << "Lookup table read from " << cache_name << "\n";
+                if(ParallelDescriptor::IOProcessor() && table_name != cache_name){
+                    WarpXUtilIO::WriteBinaryDataOnFile(table_name,
+                        engine.export_lookup_tables_data());
+                }
+                return;
+            }
+        }
+
+        engine.compute_lookup_tables(ctrl);
+
+        if(ParallelDescriptor::IOProcessor()){
+            const Vector<char> table_data = engine.export_lookup_tables_data();
+            WarpXUtilIO::WriteBinaryDataOnFile(table_name, table_data);
+            // Another run may read the cache: the file appears complete
+            if(!cache_name.empty()){
+                if(!amrex::UtilCreateDirectory(cache_dir, 0755))
+                    amrex::CreateDirectoryFailed(cache_dir);
+                const std::string tmp_name = cache_name + ".tmp";
+                if(!WarpXUtilIO::WriteBinaryDataOnFile(tmp_name, table_data) ||
+                   std::rename(tmp_name.c_str(), cache_name.c_str()) != 0){
+                    amrex::Warning("Cannot write the lookup table to " + cache_name);
+                }
+            }
+        }
+        ParallelDescriptor::Barrier();
+    }
+}
+
 void
 MultiParticleContainer::QuantumSyncGenerateTable ()
 {
@@ -828,81 +905,72 @@ MultiParticleContainer::QuantumSyncGenerateTable ()
     if(table_name.empty())
         amrex::Abort("qed_qs.save_table_in should be provided!");
 
-    if(ParallelDescriptor::IOProcessor()){
-        PicsarQuantumSynchrotronCtrl ctrl;
-        int t_int;
-
-        // Engine paramenter: chi_part_min is the minium chi parameter to be
-        // considered by the engine. If a lepton has chi < chi_part_min,
-        // the optical depth is not evolved and photon generation is ignored
-        if(!pp.query("chi_min", ctrl.chi_part_min))
-            amrex::Abort("qed_qs.chi_min should be provided!");
-
-        //==Table parameters==
-
-        //--- sub-table 1 (1D)
-        //These parameters are used to pre-compute a function
-        //which appears in the evolution of the optical depth
-
-        //Minimun chi for the table. If a lepton has chi < chi_part_tdndt_min,
-        //chi is considered as it were equal to chi_part_tdndt_min
-        if(!pp.query("tab_dndt_chi_min", ctrl.chi_part_tdndt_min))
-            amrex::Abort("qed_qs.tab_dndt_chi_min should be provided!");
-
-        //Maximum chi for the table. If a lepton has chi > chi_part_tdndt_max,
-        //chi is considered as it were equal to chi_part_tdndt_max
-        if(!pp.query("tab_dndt_chi_max", ctrl.chi_part_tdndt_max))
-            amrex::Abort("qed_qs.tab_dndt_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_dndt_how_many", t_int))
-            amrex::Abort("qed_qs.tab_dndt_how_many should be provided!");
-        ctrl.chi_part_tdndt_how_many = t_int;
-        //------
-
-        //--- sub-table 2 (2D)
-        //These parameters are used to pre-compute a function
-        //which is used to extract the properties of the generated
-        //photons.
-
-        //Minimun chi for the table. If a lepton has chi < chi_part_tem_min,
-        //chi is considered as it were equal to chi_part_tem_min
-        if(!pp.query("tab_em_chi_min", ctrl.chi_part_tem_min))
-            amrex::Abort("qed_qs.tab_em_chi_min should be provided!");
-
-        //Maximum chi for the table. If a lepton has chi > chi_part_tem_max,
-        //chi is considered as it were equal to chi_part_tem_max
-        if(!pp.query("tab_em_chi_max", ctrl.chi_part_tem_max))
-            amrex::Abort("qed_qs.tab_em_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_em_chi_how_many", t_int))
-            amrex::Abort("qed_qs.tab_em_chi_how_many should be provided!");
-        ctrl.chi_part_tem_how_many = t_int;
-
-        //The other axis of the table is a cumulative probability distribution
-        //(corresponding to different energies of the generated particles)
-        //This parameter is the number of different points to consider
-        if(!pp.query("tab_em_prob_how_many", t_int))
-            amrex::Abort("qed_qs.tab_em_prob_how_many should be provided!");
-        ctrl.prob_tem_how_many = t_int;
-        //====================
-
-        m_shr_p_qs_engine->compute_lookup_tables(ctrl);
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            m_shr_p_qs_engine->export_lookup_tables_data());
-    }
-
-    ParallelDescriptor::Barrier();
-    Vector<char> table_data;
-    ParallelDescriptor::ReadAndBcastFile(table_name, table_data);
-    ParallelDescriptor::Barrier();
-
-    //No need to initialize from raw data for the processor that
-    //has just generated the table
-    if(!ParallelDescriptor::IOProcessor()){
-        m_shr_p_qs_engine->init_lookup_tables_from_raw_data(table_data);
-    }
+    // The tables are cached in this directory, in files named after a hash
+    // of the control parameters. An empty string disables the cache.
+    std::string table_cache_dir = "qed_table_cache";
+    pp.query("table_cache_dir", table_cache_dir);
+
+    PicsarQuantumSynchrotronCtrl ctrl;
+    int t_int;
+
+    // Engine paramenter: chi_part_min is the minium chi parameter to be
+    // considered by the engine. If a lepton has chi < chi_part_min,
+    // the optical depth is not evolved and photon generation is ignored
+    if(!pp.query("chi_min", ctrl.chi_part_min))
+        amrex::Abort("qed_qs.chi_min should be provided!");
+
+    //==Table parameters==
+
+    //--- sub-table 1 (1D)
+    //These parameters are used to pre-compute a function
+    //which appears in the evolution of the optical depth
+
+    //Minimun chi for the table. If a lepton has chi < chi_part_tdndt_min,
+    //chi is considered as it were equal to chi_part_tdndt_min
+    if(!pp.query("tab_dndt_chi_min", ctrl.chi_part_tdndt_min))
+        amrex::Abort("qed_qs.tab_dndt_chi_min should be provided!");
+
+    //Maximum chi for the table. If a lepton has chi > chi_part_tdndt_max,
+    //chi is considered as it were equal to chi_part_tdndt_max
+    if(!pp.query("tab_dndt_chi_max", ctrl.chi_part_tdndt_max))
+        amrex::Abort("qed_qs.tab_dndt_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_dndt_how_many", t_int))
+        amrex::Abort("qed_qs.tab_dndt_how_many should be provided!");
+    ctrl.chi_part_tdndt_how_many = t_int;
+    //------
+
+    //--- sub-table 2 (2D)
+    //These parameters are used to pre-compute a function
+    //which is used to extract the properties of the generated
+    //photons.
+
+    //Minimun chi for the table. If a lepton has chi < chi_part_tem_min,
+    //chi is considered as it were equal to chi_part_tem_min
+    if(!pp.query("tab_em_chi_min", ctrl.chi_part_tem_min))
+        amrex::Abort("qed_qs.tab_em_chi_min should be provided!");
+
+    //Maximum chi for the table. If a lepton has chi > chi_part_tem_max,
+    //chi is considered as it were equal to chi_part_tem_max
+    if(!pp.query("tab_em_chi_max", ctrl.chi_part_tem_max))
+        amrex::Abort("qed_qs.tab_em_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_em_chi_how_many", t_int))
+        amrex::Abort("qed_qs.tab_em_chi_how_many should be provided!");
+    ctrl.chi_part_tem_how_many = t_int;
+
+    //The other axis of the table is a cumulative probability distribution
+    //(corresponding to different energies of the generated particles)
+    //This parameter is the number of different points to consider
+    if(!pp.query("tab_em_prob_how_many", t_int))
+        amrex::Abort("qed_qs.tab_em_prob_how_many should be provided!");
+    ctrl.prob_tem_how_many = t_int;
+    //====================
+
+    GenerateOrLoadTable(*m_shr_p_qs_engine, ctrl, table_name,
+        table_cache_dir, "qed_qs_table_");
 }
 
 void
@@ -914,81 +982,72 @@ MultiParticleContainer::BreitWheelerGenerateTable ()
     if(table_name.empty())
         amrex::Abort("qed_bw.save_table_in should be provided!");
 
-    if(ParallelDescriptor::IOProcessor()){
-        PicsarBreitWheelerCtrl ctrl;
-        int t_int;
-
-        // Engine paramenter: chi_phot_min is the minium chi parameter to be
-        // considered by the engine. If a photon has chi < chi_phot_min,
-        // the optical depth is not evolved and pair generation is ignored
-        if(!pp.query("chi_min", ctrl.chi_phot_min))
-            amrex::Abort("qed_bw.chi_min should be provided!");
-
-        //==Table parameters==
-
-        //--- sub-table 1 (1D)
-        //These parameters are used to pre-compute a function
-        //which appears in the evolution of the optical depth
-
-        //Minimun chi for the table. If a photon has chi < chi_phot_tdndt_min,
-        //an analytical approximation is used.
-        if(!pp.query("tab_dndt_chi_min", ctrl.chi_phot_tdndt_min))
-            amrex::Abort("qed_bw.tab_dndt_chi_min should be provided!");
-
-        //Maximum chi for the table. If a photon has chi > chi_phot_tdndt_min,
-        //an analytical approximation is used.
-        if(!pp.query("tab_dndt_chi_max", ctrl.chi_phot_tdndt_max))
-            amrex::Abort("qed_bw.tab_dndt_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_dndt_how_many", t_int))
-            amrex::Abort("qed_bw.tab_dndt_how_many should be provided!");
-        ctrl.chi_phot_tdndt_how_many = t_int;
-        //------
-
-        //--- sub-table 2 (2D)
-        //These parameters are used to pre-compute a function
-        //which is used to extract the properties of the generated
-        //particles.
-
-        //Minimun chi for the table. If a photon has chi < chi_phot_tpair_min
-        //chi is considered as it were equal to chi_phot_tpair_min
-        if(!pp.query("tab_pair_chi_min", ctrl.chi_phot_tpair_min))
-            amrex::Abort("qed_bw.tab_pair_chi_min should be provided!");
-
-        //Maximum chi for the table. If a photon has chi > chi_phot_tpair_max
-        //chi is considered as it were equal to chi_phot_tpair_max
-        if(!pp.query("tab_pair_chi_max", ctrl.chi_phot_tpair_max))
-            amrex::Abort("qed_bw.tab_pair_chi_max should be provided!");
-
-        //How many points should be used for chi in the table
-        if(!pp.query("tab_pair_chi_how_many", t_int))
-            amrex::Abort("qed_bw.tab_pair_chi_how_many should be provided!");
-        ctrl.chi_phot_tpair_how_many = t_int;
-
-        //The other axis of the table is the fraction of the initial energy
-        //'taken away' by the most energetic particle of the pair.
-        //This parameter is the number of different fractions to consider
-        if(!pp.query("tab_pair_frac_how_many", t_int))
-            amrex::Abort("qed_bw.tab_pair_frac_how_many should be provided!");
-        ctrl.chi_frac_tpair_how_many = t_int;
-        //====================
-
-        m_shr_p_bw_engine->compute_lookup_tables(ctrl);
-        WarpXUtilIO::WriteBinaryDataOnFile(table_name,
-            m_shr_p_bw_engine->export_lookup_tables_data());
-    }
-
-    ParallelDescriptor::Barrier();
-    Vector<char> table_data;
-    ParallelDescriptor::ReadAndBcastFile(table_name, table_data);
-    ParallelDescriptor::Barrier();
-
-    //No need to initialize from raw data for the processor that
-    //has just generated the table
-    if(!ParallelDescriptor::IOProcessor()){
-        m_shr_p_bw_engine->init_lookup_tables_from_raw_data(table_data);
-    }
+    // The tables are cached in this directory, in files named after a hash
+    // of the control parameters. An empty string disables the cache.
+    std::string table_cache_dir = "qed_table_cache";
+    pp.query("table_cache_dir", table_cache_dir);
+
+    PicsarBreitWheelerCtrl ctrl;
+    int t_int;
+
+    // Engine paramenter: chi_phot_min is the minium chi parameter to be
+    // considered by the engine. If a photon has chi < chi_phot_min,
+    // the optical depth is not evolved and pair generation is ignored
+    if(!pp.query("chi_min", ctrl.chi_phot_min))
+        amrex::Abort("qed_bw.chi_min should be provided!");
+
+    //==Table parameters==
+
+    //--- sub-table 1 (1D)
+    //These parameters are used to pre-compute a function
+    //which appears in the evolution of the optical depth
+
+    //Minimun chi for the table. If a photon has chi < chi_phot_tdndt_min,
+    //an analytical approximation is used.
+    if(!pp.query("tab_dndt_chi_min", ctrl.chi_phot_tdndt_min))
+        amrex::Abort("qed_bw.tab_dndt_chi_min should be provided!");
+
+    //Maximum chi for the table. If a photon has chi > chi_phot_tdndt_min,
+    //an analytical approximation is used.
+    if(!pp.query("tab_dndt_chi_max", ctrl.chi_phot_tdndt_max))
+        amrex::Abort("qed_bw.tab_dndt_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_dndt_how_many", t_int))
+        amrex::Abort("qed_bw.tab_dndt_how_many should be provided!");
+    ctrl.chi_phot_tdndt_how_many = t_int;
+    //------
+
+    //--- sub-table 2 (2D)
+    //These parameters are used to pre-compute a function
+    //which is used to extract the properties of the generated
+    //particles.
+
+    //Minimun chi for the table. If a photon has chi < chi_phot_tpair_min
+    //chi is considered as it were equal to chi_phot_tpair_min
+    if(!pp.query("tab_pair_chi_min", ctrl.chi_phot_tpair_min))
+        amrex::Abort("qed_bw.tab_pair_chi_min should be provided!");
+
+    //Maximum chi for the table. If a photon has chi > chi_phot_tpair_max
+    //chi is considered as it were equal to chi_phot_tpair_max
+    if(!pp.query("tab_pair_chi_max", ctrl.chi_phot_tpair_max))
+        amrex::Abort("qed_bw.tab_pair_chi_max should be provided!");
+
+    //How many points should be used for chi in the table
+    if(!pp.query("tab_pair_chi_how_many", t_int))
+        amrex::Abort("qed_bw.tab_pair_chi_how_many should be provided!");
+    ctrl.chi_phot_tpair_how_many = t_int;
+
+    //The other axis of the table is the fraction of the initial energy
+    //'taken away' by the most energetic particle of the pair.
+    //This parameter is the number of different fractions to consider
+    if(!pp.query("tab_pair_frac_how_many", t_int))
+        amrex::Abort("qed_bw.tab_pair_frac_how_many should be provided!");
+    ctrl.chi_frac_tpair_how_many = t_int;
+    //====================
+
+    GenerateOrLoadTable(*m_shr_p_bw_engine, ctrl, table_name,
+        table_cache_dir, "qed_bw_table_");
 }
 
 void MultiParticleContainer::doQedEvents()
@@ -1021,11 +1080,17 @@ void MultiParticleContainer::doQedBreitWheeler()
         auto phys_pc_ptr = static_cast<PhysicalParticleContainer*>(pc_source.get());
 
         const auto Filter  = phys_pc_ptr->getPairGenerationFilterFunc();
-        const auto CopyEle = copy_factory_ele.getSmartCopy();
-        const auto CopyPos = copy_factory_pos.getSmartCopy();
+        const int step = WarpX::GetInstance().getistep(0);
+        const auto CopyEle = copy_factory_ele.getSmartCopy(
+            RandomStream(RandomPurpose::ParticleCreation, step,
+                         pc_product_ele->getSpeciesId(), pc_source->getSpeciesId()));
+        const auto CopyPos = copy_factory_pos.getSmartCopy(
+            RandomStream(RandomPurpose::ParticleCreation, step,
+                         pc_product_pos->getSpeciesId(), pc_source->getSpeciesId()));
 
         const auto pair_gen_functor = m_shr_p_bw_engine->build_pair_functor();
-        auto Transform = PairGenerationTransformFunc(pair_gen_functor);
+        auto Transform = PairGenerationTransformFunc(pair_gen_functor,
+            RandomStream(RandomPurpose::BreitWheeler, step, pc_source->getSpeciesId()));
 
         pc_source ->defineAllParticleTiles();
         pc_product_pos->defineAllParticleTiles();
@@ -1078,12 +1143,16 @@ void MultiParticleContainer::doQedQuantumSync()
             static_cast<PhysicalParticleContainer*>(pc_source.get());
 
         const auto Filter   = phys_pc_ptr->getPhotonEmissionFilterFunc();
-        const auto CopyPhot = copy_factory_phot.getSmartCopy();
+        const int step = WarpX::GetInstance().getistep(0);
+        const auto CopyPhot = copy_factory_phot.getSmartCopy(
+            RandomStream(RandomPurpose::ParticleCreation, step,
+                         pc_product_phot->getSpeciesId(), pc_source->getSpeciesId()));
 
         auto Transform = PhotonEmissionTransformFunc(
             m_shr_p_qs_engine->build_optical_depth_functor(),
             pc_source->particle_runtime_comps["optical_depth_QSR"],
-             m_shr_p_qs_engine->build_phot_em_functor());
+             m_shr_p_qs_engine->build_phot_em_functor(),
+            RandomStream(RandomPurpose::QuantumSync, step, pc_source->getSpeciesId()));
 
         pc_source ->defineAllParticleTiles();
         pc_product_phot->defineAllParticleTiles();
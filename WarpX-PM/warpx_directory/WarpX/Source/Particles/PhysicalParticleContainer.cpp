@@ -15,10 +15,14 @@
 #include "WarpX.H"
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXUtil.H"
+#include "Utils/WarpXRandom.H"
 #include "Python/WarpXWrappers.h"
 #include "Utils/IonizationEnergiesTable.H"
 #include "Particles/Gather/FieldGather.H"
 #include "Particles/Pusher/GetAndSetPosition.H"
+#include "Particles/ParticleCreation/FilterCopyTransform.H"
+#include "Particles/Resampling/ParticleSplitting.H"
+#include "Particles/Resampling/ParticleMerging.H"
 
 #include "Utils/WarpXAlgorithmSelection.H"
 
@@ -28,6 +32,7 @@
 #include "Particles/Pusher/UpdateMomentumVay.H"
 #include "Particles/Pusher/UpdateMomentumBorisWithRadiationReaction.H"
 #include "Particles/Pusher/UpdateMomentumHigueraCary.H"
+#include "Particles/FusedGatherPushDeposit.H"
 
 #include <limits>
 #include <sstream>
@@ -67,6 +72,30 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
 
     pp.query("do_field_ionization", do_field_ionization);
 
+    // Initialize merging
+    pp.query("do_merging", do_merging);
+    pp.query("merging_int", merging_int);
+    pp.query("merging_min_particles_per_cell", merging_min_particles_per_cell);
+    std::vector<int> momentum_bins;
+    if (pp.queryarr("merging_momentum_bins", momentum_bins)) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(momentum_bins.size() == 3,
+            species_name + ".merging_momentum_bins must have 3 values");
+        for (int i = 0; i < 3; ++i) merging_momentum_bins[i] = momentum_bins[i];
+    }
+    if (do_merging) {
+#ifdef WARPX_DIM_RZ
+        amrex::Abort("Particle merging is not implemented in RZ geometry.");
+#endif
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(merging_int > 0,
+            species_name + ".merging_int must be positive");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(merging_momentum_bins[0] > 0 &&
+            merging_momentum_bins[1] > 0 && merging_momentum_bins[2] > 0,
+            species_name + ".merging_momentum_bins must be positive");
+        // The merged particles keep the ionization level of one of them
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!do_field_ionization,
+            "Particle merging is not supported for ionizable species.");
+    }
+
     //check if Radiation Reaction is enabled and do consistency checks
     pp.query("do_classical_radiation_reaction", do_classical_radiation_reaction);
     //if the species is not a lepton, do_classical_radiation_reaction
@@ -86,6 +115,20 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
         "Radiation reaction can be enabled only if Boris pusher is used");
     //_____________________________
 
+    // Field ionization and radiation reaction read the fields stored on the
+    // particles, so these species keep the unfused gather and push. The
+    // vectorized current deposition works on whole tiles, so it is not fused.
+    m_use_fused_kernel = WarpX::fused_particle_kernel &&
+        !do_field_ionization && !do_classical_radiation_reaction &&
+        WarpX::current_deposition_algo != CurrentDepositionAlgo::Vectorized;
+#ifdef WARPX_NO_PARTICLE_FIELDS
+    WarpXUtilMsg::AlwaysAssert(
+        !do_field_ionization && !do_classical_radiation_reaction,
+        "ERROR: field ionization and classical radiation reaction (species '"
+        + species_name + "') require compiling with USE_PARTICLE_FIELDS=TRUE"
+    );
+#endif
+
 #ifdef WARPX_QED
     pp.query("do_qed", m_do_qed);
     if(m_do_qed){
@@ -103,6 +146,9 @@ PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int isp
             m_qed_quantum_sync_phot_product_name);
     }
 
+    // The QED processes read the fields stored on the particles
+    if (m_do_qed) m_use_fused_kernel = false;
+
 
 #endif
 
@@ -251,6 +297,10 @@ PhysicalParticleContainer::AddGaussianBeam(Real x_m, Real y_m, Real z_m,
     Gpu::HostVector<ParticleReal> particle_w;
     int np = 0;
 
+    // The momenta of the beam particles are drawn from their number in the beam
+    const RandomStream random_stream(RandomPurpose::Injection,
+                                     WarpX::GetInstance().getistep(0), species_id, -1);
+
     if (ParallelDescriptor::IOProcessor()) {
         // If do_symmetrize, create 4x fewer particles, and
         // Replicate each particle 4 times (x,y) (-x,y) (x,-y) (-x,-y)
@@ -270,7 +320,8 @@ PhysicalParticleContainer::AddGaussianBeam(Real x_m, Real y_m, Real z_m,
             Real z = distz(mt);
 #endif
             if (plasma_injector->insideBounds(x, y, z)) {
-                XDim3 u = plasma_injector->getMomentum(x, y, z);
+                RandomEngine engine = random_stream.engine(static_cast<std::uint64_t>(i));
+                XDim3 u = plasma_injector->getMomentum(x, y, z, engine);
                 u.x *= PhysConst::c;
                 u.y *= PhysConst::c;
                 u.z *= PhysConst::c;
@@ -406,7 +457,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
 
     defineAllParticleTiles();
 
-    MultiFab* cost = WarpX::getCosts(lev);
+    CostLedger* cost = WarpX::getCosts(lev);
 
     const int nlevs = numLevels();
     static bool refine_injection = false;
@@ -431,6 +482,8 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
     Real gamma_boost = WarpX::gamma_boost;
     Real beta_boost = WarpX::beta_boost;
     Real t = WarpX::GetInstance().gett_new(lev);
+    const RandomStream random_stream(RandomPurpose::Injection,
+                                     WarpX::GetInstance().getistep(lev), species_id, lev);
     Real density_min = plasma_injector->density_min;
     Real density_max = plasma_injector->density_max;
 
@@ -449,7 +502,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
 #endif
     for (MFIter mfi = MakeMFIter(lev, info); mfi.isValid(); ++mfi)
     {
-        Real wt = amrex::second();
+        CostTimer cost_timer(cost, mfi.index());
 
         const Box& tile_box = mfi.tilebox();
         const RealBox tile_realbox = WarpX::getRealBox(tile_box, lev);
@@ -587,6 +640,12 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                           overlap_realbox.lo(1),
                           overlap_realbox.lo(2))};
 
+        // The random numbers of a new particle are drawn from the global
+        // index of its cell and its number in the cell, so that they do not
+        // depend on the decomposition in grids, tiles and threads.
+        const IntVect overlap_shift = shifted;
+        const Box global_cells(IntVect::TheZeroVector(), geom.Domain().length() - 1);
+
         int lrrfac = rrfac;
 
         bool loc_do_field_ionization = do_field_ionization;
@@ -616,8 +675,12 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
 
             IntVect iv = overlap_box.atOffset(cellid);
 
+            RandomEngine engine = random_stream.engine(
+                static_cast<std::uint64_t>(global_cells.index(iv + overlap_shift)),
+                static_cast<std::uint32_t>(i_part));
+
             const XDim3 r =
-                inj_pos->getPositionUnitBox(i_part, static_cast<int>(fac));
+                inj_pos->getPositionUnitBox(i_part, static_cast<int>(fac), engine);
 #if (AMREX_SPACEDIM == 3)
             Real x = overlap_corner[0] + (iv[0]+r.x)*dx[0];
             Real y = overlap_corner[1] + (iv[1]+r.y)*dx[1];
@@ -657,7 +720,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
             if (nmodes == 1) {
                 // With only 1 mode, the angle doesn't matter so
                 // choose it randomly.
-                theta = 2.*MathConst::pi*amrex::Random();
+                theta = 2.*MathConst::pi*engine.Uniform();
             } else {
                 theta = 2.*MathConst::pi*r.y;
             }
@@ -684,7 +747,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                     return;
                 }
 
-                u = inj_mom->getMomentum(x, y, z0);
+                u = inj_mom->getMomentum(x, y, z0, engine);
                 dens = inj_rho->getDensity(x, y, z0);
                 // Remove particle if density below threshold
                 if ( dens < density_min ){
@@ -731,7 +794,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
                 dens = amrex::min(dens, density_max);
 
                 // get the full momentum, including thermal motion
-                u = inj_mom->getMomentum(x, y, 0.);
+                u = inj_mom->getMomentum(x, y, 0., engine);
                 const Real gamma_lab = std::sqrt( 1.+(u.x*u.x+u.y*u.y+u.z*u.z) );
                 const Real betaz_lab = u.z/(gamma_lab);
 
@@ -747,11 +810,11 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
 
 #ifdef WARPX_QED
             if(loc_has_quantum_sync){
-                p_optical_depth_QSR[ip] = quantum_sync_get_opt();
+                p_optical_depth_QSR[ip] = quantum_sync_get_opt(engine);
             }
 
             if(loc_has_breit_wheeler){
-                p_optical_depth_BW[ip] = breit_wheeler_get_opt();
+                p_optical_depth_BW[ip] = breit_wheeler_get_opt(engine);
             }
 #endif
 
@@ -789,15 +852,7 @@ PhysicalParticleContainer::AddPlasma (int lev, RealBox part_realbox)
 #endif
         });
 
-        if (cost) {
-            wt = (amrex::second() - wt) / tile_box.d_numPts();
-            Array4<Real> const& costarr = cost->array(mfi);
-            amrex::ParallelFor(tile_box,
-            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-            {
-                costarr(i,j,k) += wt;
-            });
-        }
+        cost_timer.Charge(CostKernel::Injection);
     }
 
     // The function that calls this is responsible for redistributing particles.
@@ -874,11 +929,15 @@ PhysicalParticleContainer::FieldGather (int lev,
                                         const amrex::MultiFab& By,
                                         const amrex::MultiFab& Bz)
 {
+#ifdef WARPX_NO_PARTICLE_FIELDS
+    // The fields are not stored on the particles: nothing to gather
+    amrex::ignore_unused(lev, Ex, Ey, Ez, Bx, By, Bz);
+#else
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
 
     BL_ASSERT(OnSameGrids(lev,Ex));
 
-    MultiFab* cost = WarpX::getCosts(lev);
+    CostLedger* cost = WarpX::getCosts(lev);
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -886,7 +945,7 @@ PhysicalParticleContainer::FieldGather (int lev,
     {
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            Real wt = amrex::second();
+            CostTimer cost_timer(cost, pti.index());
 
             const Box& box = pti.validbox();
 
@@ -918,18 +977,10 @@ PhysicalParticleContainer::FieldGather (int lev,
                         Ex.nGrow(), e_is_nodal,
                         0, np, lev, lev);
 
-            if (cost) {
-                const Box& tbx = pti.tilebox();
-                wt = (amrex::second() - wt) / tbx.d_numPts();
-                Array4<Real> const& costarr = cost->array(pti);
-                amrex::ParallelFor(tbx,
-                                   [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                                   {
-                                       costarr(i,j,k) += wt;
-                                   });
-            }
+            cost_timer.Charge(CostKernel::Gather);
         }
     }
+#endif
 }
 
 void
@@ -948,6 +999,7 @@ PhysicalParticleContainer::Evolve (int lev,
     WARPX_PROFILE_VAR_NS("PPC::FieldGather", blp_fg);
     WARPX_PROFILE_VAR_NS("PPC::EvolveOpticalDepth", blp_ppc_qed_ev);
     WARPX_PROFILE_VAR_NS("PPC::ParticlePush", blp_ppc_pp);
+    WARPX_PROFILE_VAR_NS("PPC::FusedGatherPushDeposit", blp_fused);
 
     const std::array<Real,3>& dx = WarpX::CellSize(lev);
     const std::array<Real,3>& cdx = WarpX::CellSize(std::max(lev-1,0));
@@ -958,13 +1010,20 @@ PhysicalParticleContainer::Evolve (int lev,
 
     BL_ASSERT(OnSameGrids(lev,jx));
 
-    MultiFab* cost = WarpX::getCosts(lev);
+    CostLedger* cost = WarpX::getCosts(lev);
 
     const iMultiFab* current_masks = WarpX::CurrentBufferMasks(lev);
     const iMultiFab* gather_masks = WarpX::GatherBufferMasks(lev);
 
     bool has_buffer = cEx || cjx;
 
+    // The fused kernel gathers and deposits on the tile of level lev only
+    const bool use_fused_kernel = m_use_fused_kernel && !has_buffer;
+#ifdef WARPX_NO_PARTICLE_FIELDS
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!(m_use_fused_kernel && has_buffer),
+        "Gather and deposition buffers require USE_PARTICLE_FIELDS=TRUE");
+#endif
+
     if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
     {
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
@@ -978,6 +1037,7 @@ PhysicalParticleContainer::Evolve (int lev,
         }
     }
 
+    BeginDepositionTileLoop(lev);
 #ifdef _OPENMP
 #pragma omp parallel
 #endif
@@ -988,12 +1048,14 @@ PhysicalParticleContainer::Evolve (int lev,
         int thread_num = 0;
 #endif
 
-        FArrayBox filtered_Ex, filtered_Ey, filtered_Ez;
-        FArrayBox filtered_Bx, filtered_By, filtered_Bz;
+        // The filtered fields of each tile reuse the memory of the previous steps
+        Arena* const scratch_arena = WarpX::GetInstance().ScratchPool().TileArena();
+        FArrayBox filtered_Ex(scratch_arena), filtered_Ey(scratch_arena), filtered_Ez(scratch_arena);
+        FArrayBox filtered_Bx(scratch_arena), filtered_By(scratch_arena), filtered_Bz(scratch_arena);
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            Real wt = amrex::second();
+            CostTimer cost_timer(cost, pti.index());
 
             const Box& box = pti.validbox();
 
@@ -1003,12 +1065,14 @@ PhysicalParticleContainer::Evolve (int lev,
             auto& uxp = attribs[PIdx::ux];
             auto& uyp = attribs[PIdx::uy];
             auto& uzp = attribs[PIdx::uz];
+#ifndef WARPX_NO_PARTICLE_FIELDS
             auto& Exp = attribs[PIdx::Ex];
             auto& Eyp = attribs[PIdx::Ey];
             auto& Ezp = attribs[PIdx::Ez];
             auto& Bxp = attribs[PIdx::Bx];
             auto& Byp = attribs[PIdx::By];
             auto& Bzp = attribs[PIdx::Bz];
+#endif
 
             const long np = pti.numParticles();
 
@@ -1054,6 +1118,10 @@ PhysicalParticleContainer::Evolve (int lev,
 
             const long np_current = (cjx) ? nfine_current : np;
 
+            // Filtering the fields and sorting the particles in the buffers
+            // is part of the gather
+            cost_timer.Charge(CostKernel::Gather);
+
             if (rho) {
                 // Deposit charge before particle push, in component 0 of MultiFab rho.
                 int* AMREX_RESTRICT ion_lev;
@@ -1068,10 +1136,31 @@ PhysicalParticleContainer::Evolve (int lev,
                     DepositCharge(pti, wp, ion_lev, crho, 0, np_current,
                                   np-np_current, thread_num, lev, lev-1);
                 }
+                cost_timer.Charge(CostKernel::Deposit);
             }
 
-            if (! do_not_push)
+            if (! do_not_push && use_fused_kernel)
             {
+                if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics &&
+                    (a_dt_type!=DtType::SecondHalf))
+                {
+                    copy_attribs(pti);
+                }
+
+                //
+                // Field Gather, Particle Push and Current Deposition in a single kernel
+                // (the current is only needed for electromagnetic solver)
+                //
+                WARPX_PROFILE_VAR_START(blp_fused);
+                FusedGatherPushDeposit(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                       Ex.nGrow(), &jx, &jy, &jz, thread_num, lev, dt,
+                                       true, !WarpX::do_electrostatic && !do_not_deposit);
+                WARPX_PROFILE_VAR_STOP(blp_fused);
+                cost_timer.Charge(CostKernel::Push);
+            }
+            else if (! do_not_push)
+            {
+#ifndef WARPX_NO_PARTICLE_FIELDS
                 const long np_gather = (cEx) ? nfine_gather : np;
 
                 int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
@@ -1123,6 +1212,8 @@ PhysicalParticleContainer::Evolve (int lev,
                 }
 
                 WARPX_PROFILE_VAR_STOP(blp_fg);
+                cost_timer.Charge(CostKernel::Gather);
+#endif
 
 #ifdef WARPX_QED
                 //
@@ -1139,6 +1230,7 @@ PhysicalParticleContainer::Evolve (int lev,
                 WARPX_PROFILE_VAR_START(blp_ppc_pp);
                 PushPX(pti, dt, a_dt_type);
                 WARPX_PROFILE_VAR_STOP(blp_ppc_pp);
+                cost_timer.Charge(CostKernel::Push);
 
                 //
                 // Current Deposition (only needed for electromagnetic solver)
@@ -1160,6 +1252,7 @@ PhysicalParticleContainer::Evolve (int lev,
                                        np_current, np-np_current, thread_num,
                                        lev, lev-1, dt);
                     }
+                    cost_timer.Charge(CostKernel::Deposit);
                 } // end of "if !do_electrostatic"
             } // end of "if do_not_push"
 
@@ -1179,28 +1272,19 @@ PhysicalParticleContainer::Evolve (int lev,
                         DepositCharge(pti, wp, ion_lev, crho, 1, np_current,
                                       np-np_current, thread_num, lev, lev-1);
                     }
+                    cost_timer.Charge(CostKernel::Deposit);
                 }
             }
-
-            if (cost) {
-                const Box& tbx = pti.tilebox();
-                wt = (amrex::second() - wt) / tbx.d_numPts();
-                Array4<Real> const& costarr = cost->array(pti);
-                amrex::ParallelFor(tbx,
-                                   [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                                   {
-                                       costarr(i,j,k) += wt;
-                                   });
-            }
         }
     }
+    EndDepositionTileLoop();
+
     // Split particles at the end of the timestep.
     // When subcycling is ON, the splitting is done on the last call to
     // PhysicalParticleContainer::Evolve on the finest level, i.e., at the
     // end of the large timestep. Otherwise, the pushes on different levels
-    // are not consistent, and the call to Redistribute (inside
-    // SplitParticles) may result in split particles to deposit twice on the
-    // coarse level.
+    // are not consistent, and the Redistribute that follows SplitParticles
+    // may result in split particles to deposit twice on the coarse level.
     if (do_splitting && (a_dt_type == DtType::SecondHalf || a_dt_type == DtType::Full) ){
         SplitParticles(lev);
     }
@@ -1278,174 +1362,78 @@ PhysicalParticleContainer::applyNCIFilter (
 // Loop over all particles in the particle container and
 // split particles tagged with p.id()=DoSplitParticleID
 void
-PhysicalParticleContainer::SplitParticles(int lev)
+PhysicalParticleContainer::SplitParticles (int lev)
 {
-    auto& mypc = WarpX::GetInstance().GetPartContainer();
-    auto& pctmp_split = mypc.GetPCtmp();
-    RealVector psplit_x, psplit_y, psplit_z, psplit_w;
-    RealVector psplit_ux, psplit_uy, psplit_uz;
-    long np_split_to_add = 0;
-    long np_split;
-    if(split_type==0)
-    {
-        np_split = pow(2, AMREX_SPACEDIM);
-    } else {
-        np_split = 2*AMREX_SPACEDIM;
+    WARPX_PROFILE("PhysicalParticleContainer::SplitParticles()");
+
+    const std::array<Real,3>& dx = WarpX::CellSize(lev);
+    std::array<Real,3> split_offset = {dx[0]/2._rt, dx[1]/2._rt, dx[2]/2._rt};
+    const amrex::Vector<int> ppc_nd = plasma_injector->num_particles_per_cell_each_dim;
+    if (ppc_nd[0] > 0){
+        // offset for split particles is computed as a function of cell size
+        // and number of particles per cell, so that a uniform distribution
+        // before splitting results in a uniform distribution after splitting
+        split_offset[0] /= ppc_nd[0];
+        split_offset[1] /= ppc_nd[1];
+        split_offset[2] /= ppc_nd[2];
     }
+#if (AMREX_SPACEDIM == 3)
+    const GpuArray<ParticleReal,AMREX_SPACEDIM> offset {split_offset[0], split_offset[1], split_offset[2]};
+#else
+    const GpuArray<ParticleReal,AMREX_SPACEDIM> offset {split_offset[0], split_offset[2]};
+#endif
 
-    // Loop over particle interator
+    // Split particles in two along each diagonals (4 particles in 2d, 8 in 3d)
+    // or in two along each axis (4 particles in 2d, 6 in 3d)
+    constexpr int np_split_diag = 1 << AMREX_SPACEDIM;
+    constexpr int np_split_axis = 2*AMREX_SPACEDIM;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
     for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
     {
-        const auto GetPosition = GetParticlePosition(pti);
-
-        const amrex::Vector<int> ppc_nd = plasma_injector->num_particles_per_cell_each_dim;
-        const std::array<Real,3>& dx = WarpX::CellSize(lev);
-        amrex::Vector<Real> split_offset = {dx[0]/2._rt,
-                                            dx[1]/2._rt,
-                                            dx[2]/2._rt};
-        if (ppc_nd[0] > 0){
-            // offset for split particles is computed as a function of cell size
-            // and number of particles per cell, so that a uniform distribution
-            // before splitting results in a uniform distribution after splitting
-            split_offset[0] /= ppc_nd[0];
-            split_offset[1] /= ppc_nd[1];
-            split_offset[2] /= ppc_nd[2];
+        // The children are appended to the tile of their parent, and are
+        // moved to their grid and tile by the next Redistribute. They are
+        // tagged with NoSplitParticleID so that they are not re-split when
+        // entering a higher level.
+        auto& ptile = pti.GetParticleTile();
+        const int np = ptile.numParticles();
+        if (split_type == 0) {
+            filterCopyTransformParticles<np_split_diag>(ptile, ptile, np,
+                SplitParticleFilterFunc{}, SplitParticleCopyFunc{},
+                SplitParticleTransformFunc<np_split_diag>{split_type, offset});
+        } else {
+            filterCopyTransformParticles<np_split_axis>(ptile, ptile, np,
+                SplitParticleFilterFunc{}, SplitParticleCopyFunc{},
+                SplitParticleTransformFunc<np_split_axis>{split_type, offset});
         }
-        // particle Array Of Structs data
-        auto& particles = pti.GetArrayOfStructs();
-        // particle Struct Of Arrays data
-        auto& attribs = pti.GetAttribs();
-        auto& wp  = attribs[PIdx::w ];
-        auto& uxp = attribs[PIdx::ux];
-        auto& uyp = attribs[PIdx::uy];
-        auto& uzp = attribs[PIdx::uz];
-        const long np = pti.numParticles();
-        for(int i=0; i<np; i++){
-            ParticleReal xp, yp, zp;
-            GetPosition(i, xp, yp, zp);
-            auto& p = particles[i];
-            if (p.id() == DoSplitParticleID){
-                // If particle is tagged, split it and put the
-                // split particles in local arrays psplit_x etc.
-                np_split_to_add += np_split;
-#if (AMREX_SPACEDIM==2)
-                if (split_type==0){
-                    // Split particle in two along each diagonals
-                    // 4 particles in 2d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        for (int kshift = -1; kshift < 2; kshift +=2 ){
-                            // Add one particle with offset in x and z
-                            psplit_x.push_back( xp + ishift*split_offset[0] );
-                            psplit_y.push_back( yp );
-                            psplit_z.push_back( zp + kshift*split_offset[2] );
-                            psplit_ux.push_back( uxp[i] );
-                            psplit_uy.push_back( uyp[i] );
-                            psplit_uz.push_back( uzp[i] );
-                            psplit_w.push_back( wp[i]/np_split );
-                        }
-                    }
-                } else {
-                    // Split particle in two along each axis
-                    // 4 particles in 2d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        // Add one particle with offset in x
-                        psplit_x.push_back( xp + ishift*split_offset[0] );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in z
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp + ishift*split_offset[2] );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                    }
-                }
-#elif (AMREX_SPACEDIM==3)
-                if (split_type==0){
-                    // Split particle in two along each diagonals
-                    // 8 particles in 3d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        for (int jshift = -1; jshift < 2; jshift +=2 ){
-                            for (int kshift = -1; kshift < 2; kshift +=2 ){
-                                // Add one particle with offset in x, y and z
-                                psplit_x.push_back( xp + ishift*split_offset[0] );
-                                psplit_y.push_back( yp + jshift*split_offset[1] );
-                                psplit_z.push_back( zp + kshift*split_offset[2] );
-                                psplit_ux.push_back( uxp[i] );
-                                psplit_uy.push_back( uyp[i] );
-                                psplit_uz.push_back( uzp[i] );
-                                psplit_w.push_back( wp[i]/np_split );
-                            }
-                        }
-                    }
-                } else {
-                    // Split particle in two along each axis
-                    // 6 particles in 3d
-                    for (int ishift = -1; ishift < 2; ishift +=2 ){
-                        // Add one particle with offset in x
-                        psplit_x.push_back( xp + ishift*split_offset[0] );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in y
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp + ishift*split_offset[1] );
-                        psplit_z.push_back( zp );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                        // Add one particle with offset in z
-                        psplit_x.push_back( xp );
-                        psplit_y.push_back( yp );
-                        psplit_z.push_back( zp + ishift*split_offset[2] );
-                        psplit_ux.push_back( uxp[i] );
-                        psplit_uy.push_back( uyp[i] );
-                        psplit_uz.push_back( uzp[i] );
-                        psplit_w.push_back( wp[i]/np_split );
-                    }
-                }
+    }
+}
+
+// Merge the particles of each cell that have similar momenta
+void
+PhysicalParticleContainer::MergeParticles (int lev)
+{
+    WARPX_PROFILE("PhysicalParticleContainer::MergeParticles()");
+
+    const bool is_photon = AmIA<PhysicalSpecies::photon>();
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-                // invalidate the particle
-                p.m_idata.id = -p.m_idata.id;
-            }
-        }
+    for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
+    {
+        mergeParticlesInTile(pti.GetParticleTile(), pti.tilebox(), Geom(lev),
+                             merging_momentum_bins, merging_min_particles_per_cell,
+                             is_photon);
     }
-    // Add local arrays psplit_x etc. to the temporary
-    // particle container pctmp_split. Split particles
-    // are tagged with p.id()=NoSplitParticleID so that
-    // they are not re-split when entering a higher level
-    // AddNParticles calls Redistribute, so that particles
-    // in pctmp_split are in the proper grids and tiles
-    pctmp_split.AddNParticles(lev,
-                              np_split_to_add,
-                              psplit_x.dataPtr(),
-                              psplit_y.dataPtr(),
-                              psplit_z.dataPtr(),
-                              psplit_ux.dataPtr(),
-                              psplit_uy.dataPtr(),
-                              psplit_uz.dataPtr(),
-                              1,
-                              psplit_w.dataPtr(),
-                              1, NoSplitParticleID);
-    // Copy particles from tmp to current particle container
-    addParticles(pctmp_split,1);
-    // Clear tmp container
-    pctmp_split.clearParticles();
 }
 
 void
 PhysicalParticleContainer::PushPX (WarpXParIter& pti, Real dt, DtType a_dt_type)
 {
+#ifndef WARPX_NO_PARTICLE_FIELDS
 
     // This wraps the momentum and position advance so that inheritors can modify the call.
     auto& attribs = pti.GetAttribs();
@@ -1583,6 +1571,147 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti, Real dt, DtType a_dt_type)
     } else {
       amrex::Abort("Unknown particle pusher");
     };
+#else
+    amrex::ignore_unused(pti, dt, a_dt_type);
+    amrex::Abort("PhysicalParticleContainer::PushPX requires the fields on the particles "
+                 "(USE_PARTICLE_FIELDS=TRUE)");
+#endif
+}
+
+void
+PhysicalParticleContainer::FusedGatherPushDeposit (WarpXParIter& pti,
+                                                   amrex::FArrayBox const * exfab,
+                                                   amrex::FArrayBox const * eyfab,
+                                                   amrex::FArrayBox const * ezfab,
+                                                   amrex::FArrayBox const * bxfab,
+                                                   amrex::FArrayBox const * byfab,
+                                                   amrex::FArrayBox const * bzfab,
+                                                   const int ngE,
+                                                   MultiFab* jx, MultiFab* jy, MultiFab* jz,
+                                                   int thread_num, int lev, Real dt,
+                                                   bool push_position, bool do_deposit)
+{
+    WARPX_PROFILE_VAR_NS("PPC::Evolve::Accumulate", blp_accumulate);
+
+    const long np = pti.numParticles();
+    if (np == 0) return;
+
+    do_deposit = do_deposit && push_position;
+
+    auto& attribs = pti.GetAttribs();
+    ParticleReal* const AMREX_RESTRICT wp = attribs[PIdx::w].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uxp = attribs[PIdx::ux].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uyp = attribs[PIdx::uy].dataPtr();
+    ParticleReal* const AMREX_RESTRICT uzp = attribs[PIdx::uz].dataPtr();
+
+    const std::array<Real,3>& dx = WarpX::CellSize(std::max(lev,0));
+    const Real q = this->charge;
+    const Real m = this->mass;
+
+    auto& warpx_instance = WarpX::GetInstance();
+    const Real cur_time = warpx_instance.gett_new(lev);
+    const auto& time_of_last_gal_shift = warpx_instance.time_of_last_gal_shift;
+
+    // Box from which the field is gathered (see FieldGather),
+    // taking into account the Galilean shift
+    Box gather_box = pti.tilebox();
+    gather_box.grow(ngE);
+    const Real gather_time_shift = (cur_time - time_of_last_gal_shift);
+    const amrex::Array<amrex::Real,3> gather_galilean_shift = {
+        v_galilean[0]*gather_time_shift,
+        v_galilean[1]*gather_time_shift,
+        v_galilean[2]*gather_time_shift };
+    const std::array<Real,3> xyzmin_gather =
+        WarpX::LowerCorner(gather_box, gather_galilean_shift, lev);
+    const Dim3 lo_gather = lbound(gather_box);
+
+    // Box into which the current is deposited (see DepositCurrent)
+    Box tilebox = pti.tilebox();
+    Box tbx, tby, tbz;
+    Array4<Real> jx_arr, jy_arr, jz_arr;
+    IntVect jx_type, jy_type, jz_type;
+    std::array<Real,3> xyzmin_depos = {0., 0., 0.};
+    if (do_deposit) {
+        const long ngJ = jx->nGrow();
+        tbx = convert(tilebox, WarpX::jx_nodal_flag);
+        tby = convert(tilebox, WarpX::jy_nodal_flag);
+        tbz = convert(tilebox, WarpX::jz_nodal_flag);
+        tilebox.grow(ngJ);
+#ifdef AMREX_USE_GPU
+        // No tiling on GPU: deposit directly in jx (same for jy and jz)
+        jx_arr = jx->array(pti);
+        jy_arr = jy->array(pti);
+        jz_arr = jz->array(pti);
+        jx_type = (*jx)[pti].box().type();
+        jy_type = (*jy)[pti].box().type();
+        jz_type = (*jz)[pti].box().type();
+#else
+        // Tiling is on: deposit into per-thread buffers (same for jy and jz),
+        // which are zero on entry
+        tbx.grow(ngJ);
+        tby.grow(ngJ);
+        tbz.grow(ngJ);
+
+        jx_arr = FArrayBox(tbx, jx->nComp(),
+            deposition_accumulator.GetBuffer(thread_num, 0, tbx, jx->nComp())).array();
+        jy_arr = FArrayBox(tby, jy->nComp(),
+            deposition_accumulator.GetBuffer(thread_num, 1, tby, jy->nComp())).array();
+        jz_arr = FArrayBox(tbz, jz->nComp(),
+            deposition_accumulator.GetBuffer(thread_num, 2, tbz, jz->nComp())).array();
+        jx_type = tbx.type();
+        jy_type = tby.type();
+        jz_type = tbz.type();
+#endif
+        const Real depos_time_shift = (cur_time + 0.5*dt - time_of_last_gal_shift);
+        const amrex::Array<amrex::Real,3> depos_galilean_shift = {
+            v_galilean[0]*depos_time_shift,
+            v_galilean[1]*depos_time_shift,
+            v_galilean[2]*depos_time_shift };
+        xyzmin_depos = WarpX::LowerCorner(tilebox, depos_galilean_shift, lev);
+    }
+    const Dim3 lo_depos = lbound(tilebox);
+
+    const bool do_esirkepov = do_deposit &&
+        (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov);
+    if (do_esirkepov) {
+        if ( (v_galilean[0]!=0) or (v_galilean[1]!=0) or (v_galilean[2]!=0)){
+            amrex::Abort("The Esirkepov algorithm cannot be used with the Galilean algorithm.");
+        }
+    }
+
+    const auto GetPosition = GetParticlePosition(pti);
+    const auto SetPosition = SetParticlePosition(pti);
+    const auto getExternalE = GetExternalEField(pti);
+    const auto getExternalB = GetExternalBField(pti);
+
+    doFusedGatherPushDeposit(
+        WarpX::nox, WarpX::l_lower_order_in_v, do_esirkepov,
+        GetPosition, SetPosition, getExternalE, getExternalB,
+        wp, uxp, uyp, uzp,
+        exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+        jx_arr, jy_arr, jz_arr, jx_type, jy_type, jz_type,
+        np, q, m, dt, WarpX::particle_pusher_algo,
+        !do_not_gather, push_position, do_deposit,
+        dx, xyzmin_gather, lo_gather, xyzmin_depos, lo_depos,
+        WarpX::n_rz_azimuthal_modes);
+
+#ifndef AMREX_USE_GPU
+    if (do_deposit) {
+        WARPX_PROFILE_VAR_START(blp_accumulate);
+        // CPU, tiling: add the per-thread buffers into jx
+        // (same for jx and jz)
+        FArrayBox jx_fab(jx_arr, IndexType(jx_type));
+        FArrayBox jy_fab(jy_arr, IndexType(jy_type));
+        FArrayBox jz_fab(jz_arr, IndexType(jz_type));
+        deposition_accumulator.Accumulate(jx_fab, (*jx)[pti], 0,
+            pti.tilebox(), pti.validbox(), pti.tileIndex());
+        deposition_accumulator.Accumulate(jy_fab, (*jy)[pti], 0,
+            pti.tilebox(), pti.validbox(), pti.tileIndex());
+        deposition_accumulator.Accumulate(jz_fab, (*jz)[pti], 0,
+            pti.tilebox(), pti.validbox(), pti.tileIndex());
+        WARPX_PROFILE_VAR_STOP(blp_accumulate);
+    }
+#endif
 }
 
 #ifdef WARPX_QED
@@ -1645,6 +1774,23 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
     {
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
+            // Data on the grid
+            const FArrayBox& exfab = Ex[pti];
+            const FArrayBox& eyfab = Ey[pti];
+            const FArrayBox& ezfab = Ez[pti];
+            const FArrayBox& bxfab = Bx[pti];
+            const FArrayBox& byfab = By[pti];
+            const FArrayBox& bzfab = Bz[pti];
+
+            if (m_use_fused_kernel) {
+                // Gather and push the momentum, without storing the fields on the particles
+                FusedGatherPushDeposit(pti, &exfab, &eyfab, &ezfab, &bxfab, &byfab, &bzfab,
+                                       Ex.nGrow(), nullptr, nullptr, nullptr, 0, lev, dt,
+                                       false, false);
+                continue;
+            }
+
+#ifndef WARPX_NO_PARTICLE_FIELDS
             const Box& box = pti.validbox();
 
             auto& attribs = pti.GetAttribs();
@@ -1658,14 +1804,6 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
 
             const long np = pti.numParticles();
 
-            // Data on the grid
-            const FArrayBox& exfab = Ex[pti];
-            const FArrayBox& eyfab = Ey[pti];
-            const FArrayBox& ezfab = Ez[pti];
-            const FArrayBox& bxfab = Bx[pti];
-            const FArrayBox& byfab = By[pti];
-            const FArrayBox& bzfab = Bz[pti];
-
             int e_is_nodal = Ex.is_nodal() and Ey.is_nodal() and Ez.is_nodal();
             FieldGather(pti, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
                         &exfab, &eyfab, &ezfab, &bxfab, &byfab, &bzfab,
@@ -1742,7 +1880,7 @@ PhysicalParticleContainer::PushP (int lev, Real dt,
             } else {
               amrex::Abort("Unknown particle pusher");
             }
-
+#endif
         }
     }
 }
@@ -2174,7 +2312,9 @@ PhysicalParticleContainer::getIonizationFunc ()
                                 adk_exp_prefactor.dataPtr(),
                                 adk_power.dataPtr(),
                                 particle_icomps["ionization_level"],
-                                ion_atomic_number};
+                                ion_atomic_number,
+                                RandomStream(RandomPurpose::Ionization,
+                                             WarpX::GetInstance().getistep(0), species_id)};
 }
 
 #ifdef WARPX_QED
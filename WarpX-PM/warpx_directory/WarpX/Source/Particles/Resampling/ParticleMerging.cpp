@@ -0,0 +1,229 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ParticleMerging.H"
+#include "Utils/WarpXConst.H"
+
+#include <AMReX_DenseBins.H>
+#include <AMReX_ParticleTransformation.H>
+
+#include <limits>
+
+using namespace amrex;
+
+using ParticleType = WarpXParticleContainer::ParticleType;
+using index_type = DenseBins<ParticleType>::index_type;
+
+namespace {
+
+    /* Magnitude, polar angle and azimuthal angle of the momentum, in which
+       the particles of a cell are binned */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void getMomentumCoordinates (ParticleReal const ux, ParticleReal const uy,
+                                 ParticleReal const uz, Real (&q)[3]) noexcept
+    {
+        const Real u = std::sqrt(ux*ux + uy*uy + uz*uz);
+        q[0] = u;
+        q[1] = (u > 0._rt) ? std::acos(amrex::min(amrex::max(uz/u, -1._rt), 1._rt)) : 0._rt;
+        q[2] = std::atan2(uy, ux);
+    }
+
+}
+
+void
+mergeParticlesInTile (WarpXParticleContainer::ParticleTileType& ptile,
+                      const Box& box, const Geometry& geom,
+                      const GpuArray<int,3>& momentum_bins,
+                      int const min_particles_per_cell, bool const is_photon)
+{
+    const int np = ptile.numParticles();
+    if (np == 0) return;
+
+    ParticleType* const AMREX_RESTRICT pstruct = ptile.GetArrayOfStructs()().dataPtr();
+    auto& soa = ptile.GetStructOfArrays();
+    ParticleReal* const AMREX_RESTRICT w  = soa.GetRealData(PIdx::w ).dataPtr();
+    ParticleReal* const AMREX_RESTRICT ux = soa.GetRealData(PIdx::ux).dataPtr();
+    ParticleReal* const AMREX_RESTRICT uy = soa.GetRealData(PIdx::uy).dataPtr();
+    ParticleReal* const AMREX_RESTRICT uz = soa.GetRealData(PIdx::uz).dataPtr();
+
+    // Find the particles of each cell of the tile
+    const auto lo = lbound(box);
+    const auto dxi = geom.InvCellSizeArray();
+    const auto plo = geom.ProbLoArray();
+    DenseBins<ParticleType> cell_bins;
+    cell_bins.build(np, pstruct, box,
+        [=] AMREX_GPU_HOST_DEVICE (const ParticleType& p) noexcept -> IntVect
+        {
+            return IntVect(AMREX_D_DECL(
+                static_cast<int>(std::floor((p.pos(0)-plo[0])*dxi[0])) - lo.x,
+                static_cast<int>(std::floor((p.pos(1)-plo[1])*dxi[1])) - lo.y,
+                static_cast<int>(std::floor((p.pos(2)-plo[2])*dxi[2])) - lo.z));
+        });
+    const index_type* const AMREX_RESTRICT cell_offsets = cell_bins.offsetsPtr();
+    const index_type* const AMREX_RESTRICT cell_indices = cell_bins.permutationPtr();
+
+    const int ncells = box.numPts();
+    const int nbins = momentum_bins[0]*momentum_bins[1]*momentum_bins[2];
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        static_cast<Long>(ncells)*nbins < std::numeric_limits<int>::max(),
+        "Particle merging: too many momentum bins for the size of the tiles");
+    const int nkeys = ncells*nbins;
+
+    // Key of each particle: its cell and its momentum bin, over the range
+    // spanned by the momenta of the particles of the cell
+    Gpu::DeviceVector<index_type> keys(np);
+    index_type* const AMREX_RESTRICT pkeys = keys.dataPtr();
+    const GpuArray<int,3> nb = momentum_bins;
+    amrex::ParallelFor( ncells,
+        [=] AMREX_GPU_DEVICE (int i_cell) noexcept
+        {
+            index_type const cell_start = cell_offsets[i_cell];
+            index_type const cell_stop  = cell_offsets[i_cell+1];
+
+            Real qmin[3], qmax[3];
+            for (int d = 0; d < 3; ++d) {
+                qmin[d] = std::numeric_limits<Real>::max();
+                qmax[d] = std::numeric_limits<Real>::lowest();
+            }
+            for (index_type ip = cell_start; ip < cell_stop; ++ip) {
+                const index_type i = cell_indices[ip];
+                Real q[3];
+                getMomentumCoordinates(ux[i], uy[i], uz[i], q);
+                for (int d = 0; d < 3; ++d) {
+                    qmin[d] = amrex::min(qmin[d], q[d]);
+                    qmax[d] = amrex::max(qmax[d], q[d]);
+                }
+            }
+            for (index_type ip = cell_start; ip < cell_stop; ++ip) {
+                const index_type i = cell_indices[ip];
+                Real q[3];
+                getMomentumCoordinates(ux[i], uy[i], uz[i], q);
+                int ib[3];
+                for (int d = 0; d < 3; ++d) {
+                    ib[d] = (qmax[d] > qmin[d]) ?
+                        amrex::min(static_cast<int>((q[d]-qmin[d])/(qmax[d]-qmin[d])*nb[d]), nb[d]-1)
+                        : 0;
+                }
+                pkeys[i] = i_cell*nbins + (ib[0]*nb[1] + ib[1])*nb[2] + ib[2];
+            }
+        }
+    );
+
+    // Find the particles of each momentum bin of each cell
+    DenseBins<index_type> bins;
+    const Box key_box(IntVect::TheZeroVector(), IntVect(AMREX_D_DECL(nkeys-1, 0, 0)));
+    bins.build(np, pkeys, key_box,
+        [=] AMREX_GPU_HOST_DEVICE (const index_type key) noexcept -> IntVect
+        {
+            return IntVect(AMREX_D_DECL(static_cast<int>(key), 0, 0));
+        });
+    const index_type* const AMREX_RESTRICT offsets = bins.offsetsPtr();
+    const index_type* const AMREX_RESTRICT indices = bins.permutationPtr();
+
+    constexpr Real c2 = PhysConst::c*PhysConst::c;
+    amrex::ParallelFor( nkeys,
+        [=] AMREX_GPU_DEVICE (int i_key) noexcept
+        {
+            const int i_cell = i_key/nbins;
+            if (static_cast<int>(cell_offsets[i_cell+1] - cell_offsets[i_cell])
+                <= min_particles_per_cell) return;
+            index_type const start = offsets[i_key];
+            index_type const stop  = offsets[i_key+1];
+            // The particles of the bin are replaced by two particles
+            if (stop - start < 3) return;
+
+            // Total weight, mean momentum, mean energy (gamma, or |u|/c for
+            // photons) and mean position of the particles of the bin
+            Real wt = 0._rt;
+            Real et = 0._rt;
+            Real ut[3] = {0._rt, 0._rt, 0._rt};
+            Real xt[AMREX_SPACEDIM];
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) xt[d] = 0._rt;
+            for (index_type ip = start; ip < stop; ++ip) {
+                const index_type i = indices[ip];
+                const Real u2 = ux[i]*ux[i] + uy[i]*uy[i] + uz[i]*uz[i];
+                wt += w[i];
+                et += w[i]*(is_photon ? std::sqrt(u2/c2) : std::sqrt(1._rt + u2/c2));
+                ut[0] += w[i]*ux[i];
+                ut[1] += w[i]*uy[i];
+                ut[2] += w[i]*uz[i];
+                for (int d = 0; d < AMREX_SPACEDIM; ++d) xt[d] += w[i]*pstruct[i].pos(d);
+            }
+            if (wt <= 0._rt) return;
+            et /= wt;
+            for (int d = 0; d < 3; ++d) ut[d] /= wt;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) xt[d] /= wt;
+
+            // The two particles have the energy et each, so the magnitude ua
+            // of their momentum; they are symmetric with respect to ut, so
+            // that they are shifted by +/- delta perpendicularly to it
+            const Real ua2 = is_photon ? et*et*c2 : (et*et - 1._rt)*c2;
+            const Real ut2 = ut[0]*ut[0] + ut[1]*ut[1] + ut[2]*ut[2];
+            const Real delta = std::sqrt(amrex::max(ua2 - ut2, 0._rt));
+
+            // The direction of the shift is in the plane of ut and of the
+            // momentum of the first particle, or any direction perpendicular
+            // to ut when they are aligned
+            const index_type i0 = indices[start];
+            Real e[3] = {ux[i0], uy[i0], uz[i0]};
+            const Real u02 = e[0]*e[0] + e[1]*e[1] + e[2]*e[2];
+            if (ut2 > 0._rt) {
+                const Real proj = (e[0]*ut[0] + e[1]*ut[1] + e[2]*ut[2])/ut2;
+                for (int d = 0; d < 3; ++d) e[d] -= proj*ut[d];
+            }
+            Real e2 = e[0]*e[0] + e[1]*e[1] + e[2]*e[2];
+            if (e2 <= 1.e-12_rt*amrex::max(ut2, u02)) {
+                if (ut2 > 0._rt) {
+                    // Cross product of ut with the axis of its smallest component
+                    int dmin = 0;
+                    for (int d = 1; d < 3; ++d) {
+                        if (std::abs(ut[d]) < std::abs(ut[dmin])) dmin = d;
+                    }
+                    const int d1 = (dmin+1)%3;
+                    const int d2 = (dmin+2)%3;
+                    e[dmin] = 0._rt;
+                    e[d1] = ut[d2];
+                    e[d2] = -ut[d1];
+                } else {
+                    e[0] = 1._rt; e[1] = 0._rt; e[2] = 0._rt;
+                }
+                e2 = e[0]*e[0] + e[1]*e[1] + e[2]*e[2];
+            }
+            const Real inv_e = 1._rt/std::sqrt(e2);
+
+            for (index_type ip = start; ip < stop; ++ip) {
+                const index_type i = indices[ip];
+                if (ip < start + 2) {
+                    const Real sign = (ip == start) ? 1._rt : -1._rt;
+                    w[i] = 0.5_rt*wt;
+                    ux[i] = ut[0] + sign*delta*e[0]*inv_e;
+                    uy[i] = ut[1] + sign*delta*e[1]*inv_e;
+                    uz[i] = ut[2] + sign*delta*e[2]*inv_e;
+                    for (int d = 0; d < AMREX_SPACEDIM; ++d) pstruct[i].pos(d) = xt[d];
+                } else {
+                    // Removed from the tile below
+                    w[i] = 0._rt;
+                    if (pstruct[i].id() > 0) pstruct[i].id() = -pstruct[i].id();
+                }
+            }
+        }
+    );
+
+    // Remove the merged-away particles right away, so that they are not
+    // pushed, gathered or written out until the next Redistribute
+    using ConstPTDType = WarpXParticleContainer::ParticleTileType::ConstParticleTileDataType;
+    WarpXParticleContainer::ParticleTileType kept;
+    kept.define(ptile.NumRuntimeRealComps(), ptile.NumRuntimeIntComps());
+    kept.resize(np);
+    const int np_kept = filterParticles(kept, ptile,
+        [=] AMREX_GPU_HOST_DEVICE (const ConstPTDType& src, int i) noexcept -> int
+        {
+            return src.m_aos[i].id() > 0;
+        });
+    if (np_kept == np) return;
+    kept.resize(np_kept);
+    ptile.swap(kept);
+}
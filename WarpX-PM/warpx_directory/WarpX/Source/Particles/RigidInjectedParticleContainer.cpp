@@ -40,12 +40,18 @@ RigidInjectedParticleContainer::RigidInjectedParticleContainer (AmrCore* amr_cor
     pp.query("focused", focused);
     pp.query("rigid_advance", rigid_advance);
 
+#ifdef WARPX_NO_PARTICLE_FIELDS
+    amrex::Abort("RigidInjectedParticleContainer needs the fields on the particles: "
+                 "compile with USE_PARTICLE_FIELDS=TRUE");
+#endif
+    // The rigid injection rescales the gathered fields before the push
+    m_use_fused_kernel = false;
 }
 
 void RigidInjectedParticleContainer::InitData()
 {
-    done_injecting.resize(finestLevel()+1, 0);
-    zinject_plane_levels.resize(finestLevel()+1, zinject_plane/WarpX::gamma_boost);
+    done_injecting.resize(maxLevel()+1, 0);
+    zinject_plane_levels.resize(maxLevel()+1, zinject_plane/WarpX::gamma_boost);
 
     AddParticles(0); // Note - add on level 0
 
@@ -217,6 +223,7 @@ RigidInjectedParticleContainer::BoostandRemapParticles()
 void
 RigidInjectedParticleContainer::PushPX (WarpXParIter& pti, Real dt, DtType a_dt_type)
 {
+#ifndef WARPX_NO_PARTICLE_FIELDS
 
     // This wraps the momentum and position advance so that inheritors can modify the call.
     auto& attribs = pti.GetAttribs();
@@ -336,6 +343,9 @@ RigidInjectedParticleContainer::PushPX (WarpXParIter& pti, Real dt, DtType a_dt_
                                 }
                             });
     }
+#else
+    amrex::ignore_unused(pti, dt, a_dt_type);
+#endif
 }
 
 void
@@ -382,6 +392,7 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
                                        const MultiFab& Ex, const MultiFab& Ey, const MultiFab& Ez,
                                        const MultiFab& Bx, const MultiFab& By, const MultiFab& Bz)
 {
+#ifndef WARPX_NO_PARTICLE_FIELDS
     WARPX_PROFILE("RigidInjectedParticleContainer::PushP");
 
     if (do_not_push) return;
@@ -509,4 +520,7 @@ RigidInjectedParticleContainer::PushP (int lev, Real dt,
                 );
         }
     }
+#else
+    amrex::ignore_unused(lev, dt, Ex, Ey, Ez, Bx, By, Bz);
+#endif
 }
@@ -16,6 +16,7 @@
 #include "Pusher/GetAndSetPosition.H"
 #include "Pusher/UpdatePosition.H"
 #include "Deposition/CurrentDeposition.H"
+#include "Deposition/VectorizedCurrentDeposition.H"
 #include "Deposition/ChargeDeposition.H"
 
 #include <AMReX_AmrParGDB.H>
@@ -25,6 +26,9 @@
 
 using namespace amrex;
 
+DepositionAccumulator WarpXParticleContainer::deposition_accumulator;
+Vector<Vector<Real> > WarpXParticleContainer::local_jcells;
+
 WarpXParIter::WarpXParIter (ContainerType& pc, int level)
     : ParIter(pc, level, MFItInfo().SetDynamic(WarpX::do_dynamic_scheduling))
 {
@@ -34,9 +38,11 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     : ParticleContainer<0,0,PIdx::nattribs>(amr_core->GetParGDB())
     , species_id(ispecies)
 {
+#ifndef WARPX_NO_PARTICLE_FIELDS
     for (unsigned int i = PIdx::Ex; i <= PIdx::Bz; ++i) {
         communicate_real_comp[i] = false; // Don't need to communicate E and B.
     }
+#endif
     SetParticleSize();
     ReadParameters();
 
@@ -45,12 +51,14 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     particle_comps["ux"] = PIdx::ux;
     particle_comps["uy"] = PIdx::uy;
     particle_comps["uz"] = PIdx::uz;
+#ifndef WARPX_NO_PARTICLE_FIELDS
     particle_comps["Ex"] = PIdx::Ex;
     particle_comps["Ey"] = PIdx::Ey;
     particle_comps["Ez"] = PIdx::Ez;
     particle_comps["Bx"] = PIdx::Bx;
     particle_comps["By"] = PIdx::By;
     particle_comps["Bz"] = PIdx::Bz;
+#endif
 #ifdef WARPX_DIM_RZ
     particle_comps["theta"] = PIdx::theta;
 #endif
@@ -62,10 +70,8 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     #pragma omp single
     num_threads = omp_get_num_threads();
     #endif
-    local_rho.resize(num_threads);
-    local_jx.resize(num_threads);
-    local_jy.resize(num_threads);
-    local_jz.resize(num_threads);
+    deposition_accumulator.SetNumThreads(num_threads);
+    local_jcells.resize(num_threads);
 }
 
 void
@@ -198,6 +204,19 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
     Redistribute();
 }
 
+void
+WarpXParticleContainer::BeginDepositionTileLoop (int lev)
+{
+    deposition_accumulator.BeginTileLoop(MakeMFIter(lev).length(),
+                                         do_tiling ? tile_size : IntVect::TheZeroVector());
+}
+
+void
+WarpXParticleContainer::EndDepositionTileLoop ()
+{
+    deposition_accumulator.AddHalos();
+}
+
 /* \brief Current Deposition for thread thread_num
  * \param pti         : Particle iterator
  * \param wp          : Array of particle weights
@@ -257,6 +276,7 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
     Box tbx = convert(tilebox, WarpX::jx_nodal_flag);
     Box tby = convert(tilebox, WarpX::jy_nodal_flag);
     Box tbz = convert(tilebox, WarpX::jz_nodal_flag);
+    const Box tilebox_cc = tilebox;
     tilebox.grow(ngJ);
 
 #ifdef AMREX_USE_GPU
@@ -269,30 +289,25 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
     Array4<Real> const& jy_arr = jy->array(pti);
     Array4<Real> const& jz_arr = jz->array(pti);
 #else
-    // Tiling is on: jx_ptr points to local_jx[thread_num]
-    // (same for jy_ptr and jz_ptr)
+    // Tiling is on: jx_fab is a per-thread buffer
+    // (same for jy_fab and jz_fab)
     tbx.grow(ngJ);
     tby.grow(ngJ);
     tbz.grow(ngJ);
 
-    local_jx[thread_num].resize(tbx, jx->nComp());
-    local_jy[thread_num].resize(tby, jy->nComp());
-    local_jz[thread_num].resize(tbz, jz->nComp());
-
-    // local_jx[thread_num] is set to zero
-    local_jx[thread_num].setVal(0.0);
-    local_jy[thread_num].setVal(0.0);
-    local_jz[thread_num].setVal(0.0);
-
-    auto & jx_fab = local_jx[thread_num];
-    auto & jy_fab = local_jy[thread_num];
-    auto & jz_fab = local_jz[thread_num];
-    Array4<Real> const& jx_arr = local_jx[thread_num].array();
-    Array4<Real> const& jy_arr = local_jy[thread_num].array();
-    Array4<Real> const& jz_arr = local_jz[thread_num].array();
+    // The buffers of deposition_accumulator are zero on entry
+    FArrayBox jx_fab(tbx, jx->nComp(),
+                     deposition_accumulator.GetBuffer(thread_num, 0, tbx, jx->nComp()));
+    FArrayBox jy_fab(tby, jy->nComp(),
+                     deposition_accumulator.GetBuffer(thread_num, 1, tby, jy->nComp()));
+    FArrayBox jz_fab(tbz, jz->nComp(),
+                     deposition_accumulator.GetBuffer(thread_num, 2, tbz, jz->nComp()));
+    Array4<Real> const& jx_arr = jx_fab.array();
+    Array4<Real> const& jy_arr = jy_fab.array();
+    Array4<Real> const& jz_arr = jz_fab.array();
 #endif
     // GPU, no tiling: deposit directly in jx
-    // CPU, tiling: deposit into local_jx
+    // CPU, tiling: deposit into the per-thread buffer jx_fab
     // (same for jx and jz)
 
     const auto GetPosition = GetParticlePosition(pti, offset);
@@ -314,6 +329,14 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
         }
     }
 
+    // Size of the staging buffer of the vectorized deposition; the tiles that
+    // would need a larger buffer than vectorized_deposition_max_buffer_size
+    // use the direct deposition
+    long jcells_size = 0;
+    if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vectorized) {
+        jcells_size = vectorized_deposition_buffer_size(WarpX::nox, jx_fab, jy_fab, jz_fab);
+    }
+
     WARPX_PROFILE_VAR_START(blp_deposit);
     if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
         if        (WarpX::nox == 1){
@@ -335,6 +358,32 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
                 jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
                 WarpX::n_rz_azimuthal_modes);
         }
+    } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vectorized
+               && jcells_size <= vectorized_deposition_max_buffer_size) {
+#ifndef AMREX_USE_GPU
+        // Staging buffer of the vectorized deposition, for the three components
+        auto& jcells = local_jcells[thread_num];
+        jcells.resize(jcells_size);
+        if        (WarpX::nox == 1){
+            doVectorizedDepositionShapeN<1>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, jcells.dataPtr(), np_to_depose, dt, dx,
+                xyzmin, lo, q);
+        } else if (WarpX::nox == 2){
+            doVectorizedDepositionShapeN<2>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, jcells.dataPtr(), np_to_depose, dt, dx,
+                xyzmin, lo, q);
+        } else if (WarpX::nox == 3){
+            doVectorizedDepositionShapeN<3>(
+                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                jx_fab, jy_fab, jz_fab, jcells.dataPtr(), np_to_depose, dt, dx,
+                xyzmin, lo, q);
+        }
+#endif
     } else {
         if        (WarpX::nox == 1){
             doDepositionShapeN<1>(
@@ -360,11 +409,14 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
 
 #ifndef AMREX_USE_GPU
     WARPX_PROFILE_VAR_START(blp_accumulate);
-    // CPU, tiling: atomicAdd local_jx into jx
-    // (same for jx and jz)
-    (*jx)[pti].atomicAdd(local_jx[thread_num], tbx, tbx, 0, 0, jx->nComp());
-    (*jy)[pti].atomicAdd(local_jy[thread_num], tby, tby, 0, 0, jy->nComp());
-    (*jz)[pti].atomicAdd(local_jz[thread_num], tbz, tbz, 0, 0, jz->nComp());
+    // CPU, tiling: add jx_fab into jx (same for jx and jz). When depositing
+    // in the buffers, the coarsened tile boxes may overlap: add atomically.
+    const int tile_index = (lev == depos_lev) ? pti.tileIndex() : -1;
+    const Box& validbox = (lev == depos_lev) ? pti.validbox() :
+        amrex::coarsen(pti.validbox(), WarpX::RefRatio(depos_lev));
+    deposition_accumulator.Accumulate(jx_fab, (*jx)[pti], 0, tilebox_cc, validbox, tile_index);
+    deposition_accumulator.Accumulate(jy_fab, (*jy)[pti], 0, tilebox_cc, validbox, tile_index);
+    deposition_accumulator.Accumulate(jz_fab, (*jz)[pti], 0, tilebox_cc, validbox, tile_index);
     WARPX_PROFILE_VAR_STOP(blp_accumulate);
 #endif
 }
@@ -422,6 +474,7 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
         tilebox = amrex::coarsen(pti.tilebox(),ref_ratio);
     }
 
+    const Box tilebox_cc = tilebox;
     tilebox.grow(ngRho);
     const Box tb = amrex::convert(tilebox, WarpX::rho_nodal_flag);
 
@@ -432,17 +485,12 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
     MultiFab rhoi(*rho, amrex::make_alias, icomp*nc, nc);
     auto & rho_fab = rhoi.get(pti);
 #else
-    // Tiling is on: rho_fab points to local_rho[thread_num]
-
-    local_rho[thread_num].resize(tb, nc);
-
-    // local_rho[thread_num] is set to zero
-    local_rho[thread_num].setVal(0.0);
-
-    auto & rho_fab = local_rho[thread_num];
+    // Tiling is on: rho_fab is a per-thread buffer
+    // (the buffers of deposition_accumulator are zero on entry)
+    FArrayBox rho_fab(tb, nc, deposition_accumulator.GetBuffer(thread_num, 3, tb, nc));
 #endif
     // GPU, no tiling: deposit directly in rho
-    // CPU, tiling: deposit into local_rho
+    // CPU, tiling: deposit into the per-thread buffer rho_fab
 
     const auto GetPosition = GetParticlePosition(pti, offset);
 
@@ -485,7 +533,13 @@ WarpXParticleContainer::DepositCharge (WarpXParIter& pti, RealVector& wp,
 #ifndef AMREX_USE_GPU
     WARPX_PROFILE_VAR_START(blp_accumulate);
 
-    (*rho)[pti].atomicAdd(local_rho[thread_num], tb, tb, 0, icomp*nc, nc);
+    // When depositing in the buffers, the coarsened tile boxes may overlap:
+    // add atomically.
+    const int tile_index = (lev == depos_lev) ? pti.tileIndex() : -1;
+    const Box& validbox = (lev == depos_lev) ? pti.validbox() :
+        amrex::coarsen(pti.validbox(), WarpX::RefRatio(depos_lev));
+    deposition_accumulator.Accumulate(rho_fab, (*rho)[pti], icomp*nc,
+                                      tilebox_cc, validbox, tile_index);
 
     WARPX_PROFILE_VAR_STOP(blp_accumulate);
 #endif
@@ -507,6 +561,7 @@ WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::Mult
         if (reset) rho[lev]->setVal(0.0, rho[lev]->nGrow());
 
         // Loop over particle tiles and deposit charge on each level
+        BeginDepositionTileLoop(lev);
 #ifdef _OPENMP
         #pragma omp parallel
         {
@@ -531,6 +586,7 @@ WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::Mult
 #ifdef _OPENMP
         }
 #endif
+        EndDepositionTileLoop();
 
 #ifdef WARPX_DIM_RZ
         if (do_rz_volume_scaling) {
@@ -572,6 +628,7 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
     auto rho = std::unique_ptr<MultiFab>(new MultiFab(nba,dm,WarpX::ncomps,ng));
     rho->setVal(0.0);
 
+    BeginDepositionTileLoop(lev);
 #ifdef _OPENMP
 #pragma omp parallel
     {
@@ -600,6 +657,7 @@ WarpXParticleContainer::GetChargeDensity (int lev, bool local)
 #ifdef _OPENMP
     }
 #endif
+    EndDepositionTileLoop();
 
 #ifdef WARPX_DIM_RZ
     WarpX::GetInstance().ApplyInverseVolumeScalingToChargeDensity(rho.get(), lev);
@@ -728,7 +786,7 @@ WarpXParticleContainer::PushX (int lev, amrex::Real dt)
 
     if (do_not_push) return;
 
-    MultiFab* cost = WarpX::getCosts(lev);
+    CostLedger* cost = WarpX::getCosts(lev);
 
 #ifdef _OPENMP
 #pragma omp parallel
@@ -737,7 +795,7 @@ WarpXParticleContainer::PushX (int lev, amrex::Real dt)
 
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
         {
-            Real wt = amrex::second();
+            CostTimer cost_timer(cost, pti.index());
 
             //
             // Particle Push
@@ -766,16 +824,7 @@ WarpXParticleContainer::PushX (int lev, amrex::Real dt)
                 }
             );
 
-            if (cost) {
-                const Box& tbx = pti.tilebox();
-                wt = (amrex::second() - wt) / tbx.d_numPts();
-                Array4<Real> const& costarr = cost->array(pti);
-                amrex::ParallelFor(tbx,
-                [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-                {
-                    costarr(i,j,k) += wt;
-                });
-            }
+            cost_timer.Charge(CostKernel::Push);
         }
     }
 }
@@ -0,0 +1,167 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "MovingWindowStorage.H"
+
+#include <AMReX_Arena.H>
+#include <AMReX_Gpu.H>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace amrex;
+
+namespace
+{
+    //! Copy n values from src to dst, which do not overlap
+    void CopyValues (Real* AMREX_RESTRICT dst, Real const* AMREX_RESTRICT src, long n)
+    {
+        amrex::ParallelFor(n, [=] AMREX_GPU_DEVICE (long i) noexcept
+        {
+            dst[i] = src[i];
+        });
+    }
+}
+
+bool
+MovingWindowStorage::CanSlide (MultiFab const& mf, int num_shift, int dir) const
+{
+    // The values of a box are only shifted by moving its window if the
+    // shift is along the direction that varies slowest in memory.
+    if (m_spare_cells <= 0 || dir != AMREX_SPACEDIM-1 ||
+        std::abs(num_shift) > m_spare_cells) {
+        return false;
+    }
+    // The boxes must own their data, or be the windows of the buffers.
+    auto found = m_buffers.find(&mf);
+    if (found != m_buffers.end() && UsesBuffers(mf, found->second)) return true;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        if (mf[mfi].nBytesOwned() == 0) return false;
+    }
+    return true;
+}
+
+void
+MovingWindowStorage::Slide (MultiFab& mf, int num_shift, int dir)
+{
+    AMREX_ALWAYS_ASSERT(CanSlide(mf, num_shift, dir));
+
+    const int nc = mf.nComp();
+    Buffers& buffers = m_buffers[&mf];
+
+    if (!UsesBuffers(mf, buffers))
+    {
+        // First shift of mf: move the data of its boxes to buffers,
+        // at the end of the buffers from which the windows move away.
+        FreeBuffers(buffers);
+        buffers.resize(mf.local_size());
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            const Box& bx = mf[mfi].box();
+            const long slab = bx.numPts()/bx.length(dir);
+            const long window = nc*bx.numPts();
+            Buffer& b = buffers[mfi.LocalIndex()];
+            b.size = window + m_spare_cells*slab;
+            b.offset = (num_shift > 0) ? 0 : b.size - window;
+            b.data = static_cast<Real*>(The_Arena()->alloc(b.size*sizeof(Real)));
+            CopyValues(b.data + b.offset, mf[mfi].dataPtr(), window);
+        }
+        Gpu::synchronize();
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            FArrayBox& fab = mf[mfi];
+            const Buffer& b = buffers[mfi.LocalIndex()];
+            const long window = nc*fab.box().numPts();
+            fab.release();  // frees the data that was copied
+            fab.clear();
+            fab.setPtr(b.data + b.offset, window);
+        }
+    }
+
+    Vector<Real*> old_data;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi)
+    {
+        FArrayBox& fab = mf[mfi];
+        const Box& bx = fab.box();
+        const long slab = bx.numPts()/bx.length(dir);
+        const long window = nc*bx.numPts();
+        Buffer& b = buffers[mfi.LocalIndex()];
+
+        if (b.offset + num_shift*slab < 0 || b.offset + num_shift*slab + window > b.size)
+        {
+            // The spare cells are used up: copy the window back to the
+            // end of a new buffer from which it moves away.
+            Real* data = static_cast<Real*>(The_Arena()->alloc(b.size*sizeof(Real)));
+            const long offset = (num_shift > 0) ? 0 : b.size - window;
+            CopyValues(data + offset, b.data + b.offset, window);
+            old_data.push_back(b.data);
+            b.data = data;
+            b.offset = offset;
+        }
+
+        b.offset += num_shift*slab;
+        fab.clear();
+        fab.setPtr(b.data + b.offset, window);
+    }
+
+    if (!old_data.empty()) {
+        Gpu::synchronize();
+        for (Real* p : old_data) The_Arena()->free(p);
+    }
+}
+
+void
+MovingWindowStorage::Realias (MultiFab& alias, MultiFab const& mf)
+{
+    AMREX_ALWAYS_ASSERT(alias.nComp() == mf.nComp() && alias.boxArray() == mf.boxArray());
+    for (MFIter mfi(alias); mfi.isValid(); ++mfi) {
+        FArrayBox& fab = alias[mfi];
+        AMREX_ALWAYS_ASSERT(fab.nBytesOwned() == 0);
+        fab.clear();
+        fab.setPtr(const_cast<Real*>(mf[mfi].dataPtr()), mf.nComp()*mf[mfi].box().numPts());
+    }
+}
+
+void
+MovingWindowStorage::Retain (Vector<MultiFab const*> const& mfs)
+{
+    for (auto it = m_buffers.begin(); it != m_buffers.end(); )
+    {
+        const bool in_use = std::find(mfs.begin(), mfs.end(), it->first) != mfs.end()
+            && UsesBuffers(*it->first, it->second);
+        if (in_use) {
+            ++it;
+        } else {
+            FreeBuffers(it->second);
+            it = m_buffers.erase(it);
+        }
+    }
+}
+
+void
+MovingWindowStorage::Clear ()
+{
+    for (auto& kv : m_buffers) FreeBuffers(kv.second);
+    m_buffers.clear();
+}
+
+bool
+MovingWindowStorage::UsesBuffers (MultiFab const& mf, Buffers const& buffers)
+{
+    if (buffers.size() != mf.local_size()) return false;
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+        const Buffer& b = buffers[mfi.LocalIndex()];
+        if (b.data == nullptr || mf[mfi].dataPtr() != b.data + b.offset) return false;
+    }
+    return true;
+}
+
+void
+MovingWindowStorage::FreeBuffers (Buffers& buffers)
+{
+    for (Buffer& b : buffers) {
+        if (b.data) The_Arena()->free(b.data);
+    }
+    buffers.clear();
+}
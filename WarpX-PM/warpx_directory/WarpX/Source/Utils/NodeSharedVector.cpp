@@ -0,0 +1,115 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "NodeSharedVector.H"
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+using namespace amrex;
+
+namespace
+{
+    //! Bytes currently held in the windows of this process (first process of a node only)
+    long window_bytes = 0;
+
+#ifdef BL_USE_MPI
+    MPI_Comm node_comm = MPI_COMM_NULL;
+    MPI_Comm leader_comm = MPI_COMM_NULL;
+    int node_rank = 0;
+    int node_size = 1;
+
+    void FreeComms ()
+    {
+        if (leader_comm != MPI_COMM_NULL) MPI_Comm_free(&leader_comm);
+        if (node_comm != MPI_COMM_NULL) MPI_Comm_free(&node_comm);
+    }
+
+    //! Split the processes by node, the first time it is called. Collective.
+    void InitComms ()
+    {
+        if (node_comm != MPI_COMM_NULL) return;
+        const int myproc = ParallelDescriptor::MyProc();
+        MPI_Comm_split_type(ParallelDescriptor::Communicator(), MPI_COMM_TYPE_SHARED,
+                            myproc, MPI_INFO_NULL, &node_comm);
+        MPI_Comm_rank(node_comm, &node_rank);
+        MPI_Comm_size(node_comm, &node_size);
+        MPI_Comm_split(ParallelDescriptor::Communicator(),
+                       node_rank == 0 ? 0 : MPI_UNDEFINED, myproc, &leader_comm);
+        ExecOnFinalize(FreeComms);
+    }
+#endif
+}
+
+bool
+NodeShared::Enabled ()
+{
+#if defined(BL_USE_MPI) && !defined(AMREX_USE_GPU)
+    static const bool enabled = [] () {
+        int node_shared_tables = 1;
+        ParmParse pp("warpx");
+        pp.query("node_shared_tables", node_shared_tables);
+        return node_shared_tables != 0;
+    }();
+    return enabled;
+#else
+    return false;
+#endif
+}
+
+#ifdef BL_USE_MPI
+MPI_Comm
+NodeShared::NodeComm ()
+{
+    InitComms();
+    return node_comm;
+}
+
+MPI_Comm
+NodeShared::LeaderComm ()
+{
+    InitComms();
+    return leader_comm;
+}
+#endif
+
+bool
+NodeShared::IsNodeLeader ()
+{
+#ifdef BL_USE_MPI
+    InitComms();
+    return node_rank == 0;
+#else
+    return true;
+#endif
+}
+
+void
+NodeShared::RecordWindow (long bytes)
+{
+    window_bytes += bytes;
+}
+
+void
+NodeShared::PrintReport ()
+{
+    if (!Enabled()) return;
+#ifdef BL_USE_MPI
+    InitComms();
+    // Without sharing, each process of a node would hold its own copy
+    long stats[3] = {0, 0, 0}; // nodes, bytes in windows, bytes saved
+    if (node_rank == 0) {
+        stats[0] = 1;
+        stats[1] = window_bytes;
+        stats[2] = window_bytes*(node_size-1);
+    }
+    ParallelDescriptor::ReduceLongSum(stats, 3);
+    if (stats[1] == 0) return;
+    amrex::Print() << "Node-shared tables: " << stats[1]/stats[0]
+                   << " bytes per node, " << stats[2]/stats[0]
+                   << " bytes saved per node (" << stats[0] << " nodes)\n";
+#endif
+}
@@ -0,0 +1,200 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ScratchFieldPool.H"
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+#include <algorithm>
+
+using namespace amrex;
+
+namespace
+{
+    int ThreadNum ()
+    {
+#ifdef _OPENMP
+        return omp_get_thread_num();
+#else
+        return 0;
+#endif
+    }
+
+    long LocalBytes (MultiFab const& mf)
+    {
+        long bytes = 0;
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            bytes += mf[mfi].nBytes();
+        }
+        return bytes;
+    }
+}
+
+ScratchTileArena::ScratchTileArena ()
+{
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    for (int i = 0; i < nthreads; ++i) {
+        m_free.emplace_back(new FreeList);
+    }
+}
+
+void*
+ScratchTileArena::alloc (std::size_t sz)
+{
+    const int owner = ThreadNum() % m_free.size();
+    FreeList& fl = *m_free[owner];
+    void* p = nullptr;
+    std::size_t size = sz;
+    {
+        std::lock_guard<std::mutex> lock(fl.mutex);
+        // smallest kept block that fits, unless it is more than twice too large
+        auto it = fl.blocks.lower_bound(sz);
+        if (it != fl.blocks.end() && it->first <= 2*sz) {
+            size = it->first;
+            p = it->second;
+            fl.blocks.erase(it);
+        }
+    }
+    const bool reused = (p != nullptr);
+    if (!reused) p = The_Arena()->alloc(size);
+
+    std::lock_guard<std::mutex> lock(m_used_mutex);
+    m_used[p] = Block{size, owner};
+    if (reused) {
+        m_reused_bytes += size;
+    } else {
+        m_allocated_bytes += size;
+    }
+    return p;
+}
+
+void
+ScratchTileArena::free (void* pt)
+{
+    if (pt == nullptr) return;
+    Block b;
+    {
+        std::lock_guard<std::mutex> lock(m_used_mutex);
+        auto it = m_used.find(pt);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it != m_used.end(),
+            "ScratchTileArena::free: pointer not allocated by this arena");
+        b = it->second;
+        m_used.erase(it);
+    }
+    // The block goes back to the thread that allocated it, and touched it first
+    FreeList& fl = *m_free[b.owner];
+    std::lock_guard<std::mutex> lock(fl.mutex);
+    fl.blocks.emplace(b.size, pt);
+}
+
+void
+ScratchTileArena::Clear ()
+{
+    for (auto& fl : m_free) {
+        std::lock_guard<std::mutex> lock(fl->mutex);
+        for (auto& kv : fl->blocks) The_Arena()->free(kv.second);
+        fl->blocks.clear();
+    }
+}
+
+void
+ScratchTileArena::TakeStats (long& reused, long& allocated)
+{
+    std::lock_guard<std::mutex> lock(m_used_mutex);
+    reused += m_reused_bytes;
+    allocated += m_allocated_bytes;
+    m_reused_bytes = 0;
+    m_allocated_bytes = 0;
+}
+
+void
+ScratchFieldPool::GiveBack::operator() (MultiFab* mf) const
+{
+    if (pool) {
+        pool->Return(mf);
+    } else {
+        delete mf;
+    }
+}
+
+ScratchFieldPool::ScratchFieldPool (bool enabled)
+    : m_enabled(enabled)
+{
+    if (m_enabled) m_tile_arena.reset(new ScratchTileArena);
+}
+
+ScratchFieldPool::MultiFabPtr
+ScratchFieldPool::Get (const BoxArray& ba, const DistributionMapping& dm,
+                       int ncomp, const IntVect& ngrow)
+{
+    if (!m_enabled) {
+        return MultiFabPtr(new MultiFab(ba, dm, ncomp, ngrow), GiveBack{});
+    }
+
+    for (auto it = m_free.begin(); it != m_free.end(); ++it)
+    {
+        MultiFab& mf = **it;
+        if (mf.nComp() == ncomp && mf.nGrowVect() == ngrow &&
+            mf.boxArray() == ba && mf.DistributionMap() == dm)
+        {
+            MultiFabPtr p(it->release(), GiveBack{this});
+            m_free.erase(it);
+            m_reused_bytes += LocalBytes(*p);
+            return p;
+        }
+    }
+
+    MultiFabPtr p(new MultiFab(ba, dm, ncomp, ngrow), GiveBack{this});
+    // The pages are touched first by the threads that work on the tiles
+    p->setVal(0.0);
+    m_allocated_bytes += LocalBytes(*p);
+    return p;
+}
+
+Arena*
+ScratchFieldPool::TileArena ()
+{
+    return m_enabled ? m_tile_arena.get() : The_Arena();
+}
+
+void
+ScratchFieldPool::Return (MultiFab* mf)
+{
+    m_free.emplace_back(mf);
+}
+
+void
+ScratchFieldPool::Clear ()
+{
+    m_free.clear();
+    if (m_tile_arena) m_tile_arena->Clear();
+}
+
+void
+ScratchFieldPool::PrintStats (int step)
+{
+    if (!m_enabled) return;
+    long reused = m_reused_bytes;
+    long allocated = m_allocated_bytes;
+    m_tile_arena->TakeStats(reused, allocated);
+    m_reused_bytes = 0;
+    m_allocated_bytes = 0;
+
+    ParallelDescriptor::ReduceLongSum(reused, ParallelDescriptor::IOProcessorNumber());
+    ParallelDescriptor::ReduceLongSum(allocated, ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "Scratch fields at step " << step << ": "
+                   << reused/1048576. << " MB reused, "
+                   << allocated/1048576. << " MB allocated\n";
+}
@@ -101,6 +101,18 @@ WarpX::MoveWindow (bool move_j)
     int num_shift      = num_shift_base;
     int num_shift_crse = num_shift;
 
+    // The fields shifted at every move may keep their data in the buffers
+    // of moving_window_storage, and be shifted without copies.
+    Vector<MultiFab const*> slid_fields;
+    auto shiftSlidMF = [&] (MultiFab& mf, const Geometry& mf_geom, int mf_num_shift,
+                            IntVect mf_ng_extra, Real external_field, bool useparser,
+                            ParserWrapper<3> *field_parser)
+    {
+        slid_fields.push_back(&mf);
+        shiftMF(mf, mf_geom, mf_num_shift, dir, mf_ng_extra, external_field, useparser,
+                field_parser, moving_window_storage.get());
+    };
+
     // Shift the mesh fields
     for (int lev = 0; lev <= finest_level; ++lev) {
 
@@ -128,32 +140,37 @@ WarpX::MoveWindow (bool move_j)
                 if (dim == 1) Efield_parser = Eyfield_parser.get();
                 if (dim == 2) Efield_parser = Ezfield_parser.get();
             }
-            shiftMF(*Bfield_fp[lev][dim], geom[lev], num_shift, dir, ng_extra, B_external_grid[dim], use_Bparser, Bfield_parser);
-            shiftMF(*Efield_fp[lev][dim], geom[lev], num_shift, dir, ng_extra, E_external_grid[dim], use_Eparser, Efield_parser);
+            shiftSlidMF(*Bfield_fp[lev][dim], geom[lev], num_shift, ng_extra, B_external_grid[dim], use_Bparser, Bfield_parser);
+            shiftSlidMF(*Efield_fp[lev][dim], geom[lev], num_shift, ng_extra, E_external_grid[dim], use_Eparser, Efield_parser);
+            if (lev == 0 && moving_window_storage && Bfield_aux[lev][dim]->ixType() == Bfield_fp[lev][dim]->ixType()) {
+                // The aux patch of level 0 is an alias of the fine patch
+                MovingWindowStorage::Realias(*Bfield_aux[lev][dim], *Bfield_fp[lev][dim]);
+                MovingWindowStorage::Realias(*Efield_aux[lev][dim], *Efield_fp[lev][dim]);
+            }
             if (move_j) {
                 shiftMF(*current_fp[lev][dim], geom[lev], num_shift, dir, ng_zero);
             }
             if (do_pml && pml[lev]->ok()) {
                 const std::array<MultiFab*, 3>& pml_B = pml[lev]->GetB_fp();
                 const std::array<MultiFab*, 3>& pml_E = pml[lev]->GetE_fp();
-                shiftMF(*pml_B[dim], geom[lev], num_shift, dir, ng_extra);
-                shiftMF(*pml_E[dim], geom[lev], num_shift, dir, ng_extra);
+                shiftSlidMF(*pml_B[dim], geom[lev], num_shift, ng_extra, 0.0, false, nullptr);
+                shiftSlidMF(*pml_E[dim], geom[lev], num_shift, ng_extra, 0.0, false, nullptr);
             }
 
             if (lev > 0) {
                 // coarse grid
-                shiftMF(*Bfield_cp[lev][dim], geom[lev-1], num_shift_crse, dir, ng_zero, B_external_grid[dim], use_Bparser, Bfield_parser);
-                shiftMF(*Efield_cp[lev][dim], geom[lev-1], num_shift_crse, dir, ng_zero, E_external_grid[dim], use_Eparser, Efield_parser);
-                shiftMF(*Bfield_aux[lev][dim], geom[lev], num_shift, dir, ng_zero);
-                shiftMF(*Efield_aux[lev][dim], geom[lev], num_shift, dir, ng_zero);
+                shiftSlidMF(*Bfield_cp[lev][dim], geom[lev-1], num_shift_crse, ng_zero, B_external_grid[dim], use_Bparser, Bfield_parser);
+                shiftSlidMF(*Efield_cp[lev][dim], geom[lev-1], num_shift_crse, ng_zero, E_external_grid[dim], use_Eparser, Efield_parser);
+                shiftSlidMF(*Bfield_aux[lev][dim], geom[lev], num_shift, ng_zero, 0.0, false, nullptr);
+                shiftSlidMF(*Efield_aux[lev][dim], geom[lev], num_shift, ng_zero, 0.0, false, nullptr);
                 if (move_j) {
                     shiftMF(*current_cp[lev][dim], geom[lev-1], num_shift_crse, dir, ng_zero);
                 }
                 if (do_pml && pml[lev]->ok()) {
                     const std::array<MultiFab*, 3>& pml_B = pml[lev]->GetB_cp();
                     const std::array<MultiFab*, 3>& pml_E = pml[lev]->GetE_cp();
-                    shiftMF(*pml_B[dim], geom[lev-1], num_shift_crse, dir, ng_extra);
-                    shiftMF(*pml_E[dim], geom[lev-1], num_shift_crse, dir, ng_extra);
+                    shiftSlidMF(*pml_B[dim], geom[lev-1], num_shift_crse, ng_extra, 0.0, false, nullptr);
+                    shiftSlidMF(*pml_E[dim], geom[lev-1], num_shift_crse, ng_extra, 0.0, false, nullptr);
                 }
             }
         }
@@ -161,17 +178,17 @@ WarpX::MoveWindow (bool move_j)
         // Shift scalar component F for dive cleaning
         if (do_dive_cleaning) {
             // Fine grid
-            shiftMF(*F_fp[lev], geom[lev], num_shift, dir, ng_zero);
+            shiftSlidMF(*F_fp[lev], geom[lev], num_shift, ng_zero, 0.0, false, nullptr);
             if (do_pml && pml[lev]->ok()) {
                 MultiFab* pml_F = pml[lev]->GetF_fp();
-                shiftMF(*pml_F, geom[lev], num_shift, dir, ng_extra);
+                shiftSlidMF(*pml_F, geom[lev], num_shift, ng_extra, 0.0, false, nullptr);
             }
             if (lev > 0) {
                 // Coarse grid
-                shiftMF(*F_cp[lev], geom[lev-1], num_shift_crse, dir, ng_zero);
+                shiftSlidMF(*F_cp[lev], geom[lev-1], num_shift_crse, ng_zero, 0.0, false, nullptr);
                 if (do_pml && pml[lev]->ok()) {
                     MultiFab* pml_F = pml[lev]->GetF_cp();
-                    shiftMF(*pml_F, geom[lev-1], num_shift_crse, dir, ng_zero);
+                    shiftSlidMF(*pml_F, geom[lev-1], num_shift_crse, ng_zero, 0.0, false, nullptr);
                 }
                 shiftMF(*rho_cp[lev], geom[lev-1], num_shift_crse, dir, ng_zero);
             }
@@ -190,6 +207,11 @@ WarpX::MoveWindow (bool move_j)
         }
     }
 
+    if (moving_window_storage) {
+        // Free the buffers of the fields that were reallocated
+        moving_window_storage->Retain(slid_fields);
+    }
+
     Real start_timer=amrex::second();
     // Continuously inject plasma in new cells (by default only on level 0)
     if (WarpX::warpx_do_continuous_injection) {
@@ -237,7 +259,7 @@ WarpX::MoveWindow (bool move_j)
 void
 WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
                 IntVect ng_extra, amrex::Real external_field, bool useparser,
-                ParserWrapper<3> *field_parser)
+                ParserWrapper<3> *field_parser, MovingWindowStorage* storage)
 {
     WARPX_PROFILE("WarpX::shiftMF()");
     const BoxArray& ba = mf.boxArray();
@@ -247,12 +269,42 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
 
     AMREX_ALWAYS_ASSERT(ng.min() >= num_shift);
 
-    MultiFab tmpmf(ba, dm, nc, ng);
-    MultiFab::Copy(tmpmf, mf, 0, 0, nc, ng);
+    // Shift the values of mf by moving the start of their data in the
+    // buffers of storage, or by copying them from a temporary MultiFab.
+    const bool slide = storage && storage->CanSlide(mf, num_shift, dir);
+
+    ScratchFieldPool& pool = WarpX::GetInstance().ScratchPool();
+
+    // The num_shift slabs of cells at the end of the boxes are not shifted:
+    // they keep their values.
+    Vector<std::unique_ptr<FArrayBox> > kept;
+    ScratchFieldPool::MultiFabPtr tmpmf;
+    if (slide) {
+        kept.resize(mf.local_size());
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            Box keptBox = mfi.fabbox();
+            if (num_shift > 0) {
+                keptBox.setSmall(dir, keptBox.bigEnd(dir) - num_shift + 1);
+            } else {
+                keptBox.setBig(dir, keptBox.smallEnd(dir) - num_shift - 1);
+            }
+            kept[mfi.LocalIndex()].reset(new FArrayBox(keptBox, nc, pool.TileArena()));
+            auto const& keptfab = kept[mfi.LocalIndex()]->array();
+            auto const& srcfab = mf.array(mfi);
+            AMREX_PARALLEL_FOR_4D ( keptBox, nc, i, j, k, n,
+            {
+                keptfab(i,j,k,n) = srcfab(i,j,k,n);
+            });
+        }
+    } else {
+        tmpmf = pool.Get(ba, dm, nc, ng);
+        MultiFab::Copy(*tmpmf, mf, 0, 0, nc, ng);
+    }
+    MultiFab& srcmf = slide ? mf : *tmpmf;
 
     if ( WarpX::safe_guard_cells ) {
         // Fill guard cells.
-        tmpmf.FillBoundary(geom.periodicity());
+        srcmf.FillBoundary(geom.periodicity());
     } else {
         IntVect ng_mw = IntVect::TheUnitVector();
         // Enough guard cells in the MW direction
@@ -262,7 +314,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
         // Make sure we don't exceed number of guard cells allocated
         ng_mw = ng_mw.min(ng);
         // Fill guard cells.
-        tmpmf.FillBoundary(ng_mw, geom.periodicity());
+        srcmf.FillBoundary(ng_mw, geom.periodicity());
     }
 
     // Make a box that covers the region that the window moved into
@@ -301,10 +353,9 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
 #endif
 
 
-    for (MFIter mfi(tmpmf); mfi.isValid(); ++mfi )
+    for (MFIter mfi(srcmf); mfi.isValid(); ++mfi )
     {
-        auto const& dstfab = mf.array(mfi);
-        auto const& srcfab = tmpmf.array(mfi);
+        auto const& srcfab = srcmf.array(mfi);
 
         const Box& outbox = mfi.fabbox() & adjBox;
 
@@ -316,7 +367,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
                 });
             } else if (useparser == true) {
                 // index type of the src mf
-                auto const& mf_IndexType = (tmpmf).ixType();
+                auto const& mf_IndexType = srcmf.ixType();
                 IntVect mf_type(AMREX_D_DECL(0,0,0));
                 for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
                     mf_type[idim] = mf_IndexType.nodeCentered(idim);
@@ -343,6 +394,29 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
             }
 
         }
+    }
+
+    if (slide) {
+        storage->Slide(mf, num_shift, dir);
+        for (MFIter mfi(mf); mfi.isValid(); ++mfi) {
+            auto const& dstfab = mf.array(mfi);
+            auto const& keptfab = kept[mfi.LocalIndex()]->const_array();
+            AMREX_PARALLEL_FOR_4D ( kept[mfi.LocalIndex()]->box(), nc, i, j, k, n,
+            {
+                dstfab(i,j,k,n) = keptfab(i,j,k,n);
+            });
+        }
+        Gpu::synchronize();
+        return;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*tmpmf); mfi.isValid(); ++mfi )
+    {
+        auto const& dstfab = mf.array(mfi);
+        auto const& srcfab = tmpmf->array(mfi);
 
         Box dstBox = mf[mfi].box();
         if (num_shift > 0) {
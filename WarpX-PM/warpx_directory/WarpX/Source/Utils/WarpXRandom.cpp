@@ -0,0 +1,17 @@
+/* Copyright 2020
+ *
+ * This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "WarpXRandom.H"
+
+namespace WarpXRandomImpl
+{
+    std::uint64_t global_seed = 1;
+}
+
+void SetRandomStreamSeed (std::uint64_t seed)
+{
+    WarpXRandomImpl::global_seed = seed;
+}
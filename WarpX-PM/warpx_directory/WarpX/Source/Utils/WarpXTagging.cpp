@@ -7,35 +7,219 @@
  */
 
 #include <WarpX.H>
-#include <AMReX_BoxIterator.H>
+#include <AMReX_MultiFabUtil.H>
 #include <array>
 #include <algorithm>
+#include <cmath>
 
 using namespace amrex;
 
 void
-WarpX::ErrorEst (int lev, TagBoxArray& tags, Real /*time*/, int /*ngrow*/)
+WarpX::ErrorEst (int lev, TagBoxArray& tags, Real time, int /*ngrow*/)
 {
-    const Real* problo = Geom(lev).ProbLo();
-    const Real* dx = Geom(lev).CellSize();
+    WARPX_PROFILE("WarpX::ErrorEst()");
+
+    const auto problo = Geom(lev).ProbLoArray();
+    const auto dx = Geom(lev).CellSizeArray();
+
+    // Criteria that depend on the particles and the fields
+    std::unique_ptr<MultiFab> density;
+    if (!refine_density_species.empty()) density = RefineNumberDensity(lev);
+    std::unique_ptr<MultiFab> Emag;
+    if (refine_E_threshold > 0. || refine_E_gradient_threshold > 0.) Emag = RefineFieldMagnitude(lev);
+
+    // The guard cells of Emag that are filled from a neighboring box of the
+    // same level: the gradient is one-sided next to the others, which are
+    // outside of the domain or, on the refined levels, outside of the patch
+    iMultiFab filled;
+    if (refine_E_gradient_threshold > 0.) {
+        filled.define(boxArray(lev), DistributionMap(lev), 1, Emag->nGrow());
+        filled.setVal(0);
+        filled.setVal(1, 0, 1, 0);
+        filled.FillBoundary(Geom(lev).periodicity());
+    }
+
+    // Cells already covered by the next level, where the thresholds are
+    // multiplied by the hysteresis factor
+    iMultiFab covered;
+    if (lev < finest_level) {
+        covered = makeFineMask(boxArray(lev), DistributionMap(lev), boxArray(lev+1), refRatio(lev));
+    } else {
+        covered.define(boxArray(lev), DistributionMap(lev), 1, 0);
+        covered.setVal(0);
+    }
+
+    const bool tag_box = fine_tag_box;
+    const RealVect tag_lo = fine_tag_lo;
+    const RealVect tag_hi = fine_tag_hi;
+    const Real density_threshold = refine_density_threshold;
+    const Real E_threshold = refine_E_threshold;
+    const Real E_gradient_threshold = refine_E_gradient_threshold;
+    const Real hysteresis = refine_hysteresis;
+    ParserWrapper<4>* const refine_function = refine_function_parser.get();
 
 #ifdef _OPENMP
-#pragma omp parallel
+#pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-    for (MFIter mfi(tags); mfi.isValid(); ++mfi)
+    for (MFIter mfi(tags, TilingIfNotGPU()); mfi.isValid(); ++mfi)
     {
-        auto& fab = tags[mfi];
-        const Box& bx = fab.box();
-        for (BoxIterator bi(bx); bi.ok(); ++bi)
+        const Box& bx = mfi.tilebox();
+        auto const& tag = tags.array(mfi);
+        auto const& cov = covered.const_array(mfi);
+        Array4<Real const> const& n = density ? density->const_array(mfi) : Array4<Real const>{};
+        Array4<Real const> const& E = Emag ? Emag->const_array(mfi) : Array4<Real const>{};
+        Array4<int const> const& f = filled.ok() ? filled.const_array(mfi) : Array4<int const>{};
+
+        ParallelFor(bx,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
         {
-            const IntVect& cell = bi();
-            RealVect pos {AMREX_D_DECL((cell[0]+0.5_rt)*dx[0]+problo[0],
-                                       (cell[1]+0.5_rt)*dx[1]+problo[1],
-                                       (cell[2]+0.5_rt)*dx[2]+problo[2])};
-            if (pos > fine_tag_lo && pos < fine_tag_hi) {
-                fab(cell) = TagBox::SET;
+            const Real factor = cov(i,j,k) ? hysteresis : 1._rt;
+            const RealVect pos {AMREX_D_DECL((i+0.5_rt)*dx[0]+problo[0],
+                                             (j+0.5_rt)*dx[1]+problo[1],
+                                             (k+0.5_rt)*dx[2]+problo[2])};
+            bool refine = tag_box && pos > tag_lo && pos < tag_hi;
+            if (density_threshold > 0.) {
+                refine = refine || n(i,j,k) > factor*density_threshold;
+            }
+            if (E_threshold > 0.) {
+                refine = refine || E(i,j,k) > factor*E_threshold;
+            }
+            if (E_gradient_threshold > 0.) {
+                const IntVect iv(AMREX_D_DECL(i,j,k));
+                Real grad2 = 0.;
+                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                    IntVect ivm = iv, ivp = iv;
+                    ivm[idim] -= 1;
+                    ivp[idim] += 1;
+                    if (!f(ivm)) ivm = iv;
+                    if (!f(ivp)) ivp = iv;
+                    if (ivp == ivm) continue;
+                    const Real g = (E(ivp) - E(ivm))/((ivp[idim]-ivm[idim])*dx[idim]);
+                    grad2 += g*g;
+                }
+                refine = refine || grad2 > factor*factor*E_gradient_threshold*E_gradient_threshold;
             }
+            if (refine_function) {
+#if (AMREX_SPACEDIM == 3)
+                refine = refine || (*refine_function)(pos[0], pos[1], pos[2], time) > 0.;
+#else
+                refine = refine || (*refine_function)(pos[0], 0._rt, pos[1], time) > 0.;
+#endif
+            }
+            if (refine) tag(i,j,k) = TagBox::SET;
+        });
+    }
+}
+
+std::unique_ptr<MultiFab>
+WarpX::RefineNumberDensity (int lev)
+{
+    WARPX_PROFILE("WarpX::RefineNumberDensity()");
+
+    std::unique_ptr<MultiFab> density(new MultiFab(boxArray(lev), DistributionMap(lev), 1, 0));
+    density->setVal(0.);
+
+    const auto problo = Geom(lev).ProbLoArray();
+    const auto dxi = Geom(lev).InvCellSizeArray();
+    const Real inv_volume = AMREX_D_TERM(dxi[0], *dxi[1], *dxi[2]);
+
+    const std::vector<std::string> species_names = mypc->GetSpeciesNames();
+    for (const auto& name : refine_density_species)
+    {
+        const auto it = std::find(species_names.begin(), species_names.end(), name);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it != species_names.end(),
+            "warpx.refine_density_species: unknown species " + name);
+        auto& pc = mypc->GetParticleContainer(it - species_names.begin());
+
+        // The particles are not allocated yet when the grids are first made
+        const int finest_particle_level = std::min(pc.finestLevel(),
+                                                   static_cast<int>(pc.GetParticles().size())-1);
+        IntVect ratio = IntVect::TheUnitVector();
+        for (int plev = lev; plev <= finest_particle_level; ++plev)
+        {
+            if (plev > lev) ratio *= refRatio(plev-1);
+
+            // The particles of level plev are binned in the cells of level lev
+            // that cover the boxes of plev, which share their mapping
+            BoxArray cba = boxArray(plev);
+            cba.coarsen(ratio);
+            MultiFab count(cba, DistributionMap(plev), 1, 0);
+            count.setVal(0.);
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+            {
+                FArrayBox local_count;
+                for (WarpXParIter pti(pc, plev); pti.isValid(); ++pti)
+                {
+                    const Box cbx = amrex::coarsen(pti.tilebox(), ratio);
+                    local_count.resize(cbx, 1);
+                    local_count.setVal<RunOn::Host>(0.);
+                    Array4<Real> const& c = local_count.array();
+                    const auto clo = lbound(cbx);
+                    const auto chi = ubound(cbx);
+
+                    const auto* const AMREX_RESTRICT pstruct = pti.GetArrayOfStructs()().dataPtr();
+                    const ParticleReal* const AMREX_RESTRICT w = pti.GetAttribs(PIdx::w).dataPtr();
+                    const long np = pti.numParticles();
+                    for (long ip = 0; ip < np; ++ip)
+                    {
+                        // Particles outside of their tile are counted at its boundary
+                        AMREX_D_TERM(
+                            const int i = std::min(std::max(static_cast<int>(std::floor(
+                                (pstruct[ip].pos(0)-problo[0])*dxi[0])), clo.x), chi.x);,
+                            const int j = std::min(std::max(static_cast<int>(std::floor(
+                                (pstruct[ip].pos(1)-problo[1])*dxi[1])), clo.y), chi.y);,
+                            const int k = std::min(std::max(static_cast<int>(std::floor(
+                                (pstruct[ip].pos(2)-problo[2])*dxi[2])), clo.z), chi.z);)
+#if (AMREX_SPACEDIM == 3)
+                        c(i,j,k) += w[ip];
+#else
+                        c(i,j,0) += w[ip];
+#endif
+                    }
+                    // The coarsened tiles of a box may overlap
+                    count[pti].atomicAdd<RunOn::Host>(local_count, cbx, cbx, 0, 0, 1);
+                }
+            }
+            density->ParallelAdd(count, 0, 0, 1);
         }
     }
+    density->mult(inv_volume);
+    return density;
 }
 
+std::unique_ptr<MultiFab>
+WarpX::RefineFieldMagnitude (int lev)
+{
+    WARPX_PROFILE("WarpX::RefineFieldMagnitude()");
+
+    std::unique_ptr<MultiFab> Emag(new MultiFab(boxArray(lev), DistributionMap(lev), 1, 1));
+    Emag->setVal(0.);
+
+    // The full field: on level 0, the fine patch, whose nodal copy may not be
+    // filled yet when the grids are first made
+    const auto& E = (lev == 0) ? Efield_fp[0] : Efield_aux[lev];
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(*Emag, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& bx = mfi.tilebox();
+        auto const& m = Emag->array(mfi);
+        auto const& Ex = E[0]->const_array(mfi);
+        auto const& Ey = E[1]->const_array(mfi);
+        auto const& Ez = E[2]->const_array(mfi);
+        // The components at the lower corner of the cell: the staggering does
+        // not matter for the tagging
+        ParallelFor(bx,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            m(i,j,k) = std::sqrt(Ex(i,j,k)*Ex(i,j,k) + Ey(i,j,k)*Ey(i,j,k) + Ez(i,j,k)*Ez(i,j,k));
+        });
+    }
+    Emag->FillBoundary(Geom(lev).periodicity());
+    return Emag;
+}
@@ -82,9 +82,11 @@ void ConvertLabParamsToBoost()
 
 
     pp_amr.query("max_level", max_level);
+    // The refined patch may also be given by other tagging criteria
+    bool fine_tag_box = false;
     if (max_level > 0){
-      pp_wpx.getarr("fine_tag_lo", fine_tag_lo);
-      pp_wpx.getarr("fine_tag_hi", fine_tag_hi);
+      fine_tag_box = pp_wpx.queryarr("fine_tag_lo", fine_tag_lo);
+      if (fine_tag_box) pp_wpx.getarr("fine_tag_hi", fine_tag_hi);
     }
 
 
@@ -102,7 +104,7 @@ void ConvertLabParamsToBoost()
             convert_factor = 1./( gamma_boost * ( 1 - beta_boost ) );
             prob_lo[idim] *= convert_factor;
             prob_hi[idim] *= convert_factor;
-            if (max_level > 0){
+            if (fine_tag_box){
               fine_tag_lo[idim] *= convert_factor;
               fine_tag_hi[idim] *= convert_factor;
             }
@@ -114,7 +116,7 @@ void ConvertLabParamsToBoost()
 
     pp_geom.addarr("prob_lo", prob_lo);
     pp_geom.addarr("prob_hi", prob_hi);
-    if (max_level > 0){
+    if (fine_tag_box){
       pp_wpx.addarr("fine_tag_lo", fine_tag_lo);
       pp_wpx.addarr("fine_tag_hi", fine_tag_hi);
     }
@@ -16,6 +16,7 @@
 #include "Utils/WarpXUtil.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/WarpXProfilerWrapper.H"
+#include "Utils/WarpXRandom.H"
 
 #include <AMReX_ParmParse.H>
 #include <AMReX_MultiFabUtil.H>
@@ -105,6 +106,11 @@ Real WarpX::dt_slice_snapshots_lab;
 Real WarpX::particle_slice_width_lab = 0.0;
 
 bool WarpX::do_dynamic_scheduling = true;
+#ifdef WARPX_NO_PARTICLE_FIELDS
+bool WarpX::fused_particle_kernel = true;
+#else
+bool WarpX::fused_particle_kernel = false;
+#endif
 
 int WarpX::do_electrostatic = 0;
 int WarpX::do_subcycling = 0;
@@ -249,6 +255,8 @@ WarpX::WarpX ()
 
     pml.resize(nlevs_max);
 
+    m_load_balance_decisions.resize(nlevs_max);
+
     switch (WarpX::load_balance_costs_update_algo)
     {
         case LoadBalanceCostsUpdateAlgo::Timers: costs.resize(nlevs_max);
@@ -366,6 +374,8 @@ WarpX::WarpX ()
 
 WarpX::~WarpX ()
 {
+    FinishCheckPointFile();
+
     const int nlevs_max = maxLevel() +1;
     for (int lev = 0; lev < nlevs_max; ++lev) {
         ClearLevel(lev);
@@ -413,13 +423,21 @@ WarpX::ReadParameters ()
         if ( random_seed != "default" ) {
             unsigned long myproc_1 = ParallelDescriptor::MyProc() + 1;
             if ( random_seed == "random" ) {
-                std::random_device rd;
-                std::uniform_int_distribution<int> dist(2, INT_MAX);
-                unsigned long seed = myproc_1 * dist(rd);
+                // The counter-based random streams need the same seed on all the ranks
+                int base_seed = 0;
+                if (ParallelDescriptor::IOProcessor()) {
+                    std::random_device rd;
+                    std::uniform_int_distribution<int> dist(2, INT_MAX);
+                    base_seed = dist(rd);
+                }
+                ParallelDescriptor::Bcast(&base_seed, 1, ParallelDescriptor::IOProcessorNumber());
+                unsigned long seed = myproc_1 * base_seed;
                 ResetRandomSeed(seed);
+                SetRandomStreamSeed(base_seed);
             } else if ( std::stoi(random_seed) > 0 ) {
                 unsigned long seed = myproc_1 * std::stoul(random_seed);
                 ResetRandomSeed(seed);
+                SetRandomStreamSeed(std::stoul(random_seed));
             } else {
                 Abort("warpx.random_seed must be \"default\", \"random\" or an integer > 0.");
             }
@@ -431,6 +449,10 @@ WarpX::ReadParameters ()
         pp.query("do_subcycling", do_subcycling);
         pp.query("use_hybrid_QED", use_hybrid_QED);
         pp.query("safe_guard_cells", safe_guard_cells);
+
+        int use_scratch_pool = 1;
+        pp.query("use_scratch_pool", use_scratch_pool);
+        scratch_pool.reset(new ScratchFieldPool(use_scratch_pool));
         pp.query("override_sync_int", override_sync_int);
 
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(do_subcycling != 1 || max_level <= 1,
@@ -474,6 +496,17 @@ WarpX::ReadParameters ()
 
             pp.get("moving_window_v", moving_window_v);
             moving_window_v *= PhysConst::c;
+
+            int moving_window_spare_cells = 0;
+            pp.query("moving_window_spare_cells", moving_window_spare_cells);
+            if (moving_window_spare_cells > 0) {
+                if (moving_window_dir == AMREX_SPACEDIM-1) {
+                    moving_window_storage.reset(new MovingWindowStorage(moving_window_spare_cells));
+                } else {
+                    amrex::Print() << "WARNING: warpx.moving_window_spare_cells is only used when"
+                                   << " moving_window_dir is z: the fields are copied at each move.\n";
+                }
+            }
         }
 
         pp.query("do_back_transformed_diagnostics", do_back_transformed_diagnostics);
@@ -658,22 +691,67 @@ WarpX::ReadParameters ()
             pp.query("particle_io_nfiles", particle_io_nfiles);
             ParmParse ppp("particles");
             ppp.add("particles_nfiles", particle_io_nfiles);
+            pp.query("async_checkpoint", async_checkpoint);
+            pp.query("async_checkpoint_threads", async_checkpoint_threads);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(async_checkpoint_threads >= 1,
+                "warpx.async_checkpoint_threads must be at least 1");
+
+            pp.query("pmem_check_int", pmem_check_int);
+            pp.query("pmem_check_dir", pmem_check_dir);
+            pp.query("pmem_restart", pmem_restart);
+            if (pmem_restart) {
+                restart_chkfile = PMemCheckpoint::LatestSlot(pmem_check_dir);
+                if (restart_chkfile.empty()) {
+                    amrex::Abort("warpx.pmem_restart: no complete checkpoint in " + pmem_check_dir);
+                }
+            }
         }
 
         if (maxLevel() > 0) {
             Vector<Real> lo, hi;
-            pp.getarr("fine_tag_lo", lo);
-            pp.getarr("fine_tag_hi", hi);
-            fine_tag_lo = RealVect{lo};
-            fine_tag_hi = RealVect{hi};
+            fine_tag_box = pp.queryarr("fine_tag_lo", lo);
+            if (fine_tag_box) {
+                pp.getarr("fine_tag_hi", hi);
+                fine_tag_lo = RealVect{lo};
+                fine_tag_hi = RealVect{hi};
+            }
+            pp.queryarr("refine_density_species", refine_density_species);
+            if (!refine_density_species.empty()) {
+                pp.get("refine_density_threshold", refine_density_threshold);
+            }
+            pp.query("refine_E_threshold", refine_E_threshold);
+            pp.query("refine_E_gradient_threshold", refine_E_gradient_threshold);
+            if (pp.contains("refine_function(x,y,z,t)")) {
+                std::string str_refine_function;
+                Store_parserString(pp, "refine_function(x,y,z,t)", str_refine_function);
+                refine_function_parser.reset(new ParserWrapper<4>(
+                    makeParser(str_refine_function, {"x","y","z","t"})));
+            }
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                fine_tag_box || !refine_density_species.empty() || refine_E_threshold > 0. ||
+                refine_E_gradient_threshold > 0. || refine_function_parser,
+                "With mesh refinement, the cells to refine must be given by warpx.fine_tag_lo "
+                "and fine_tag_hi, refine_density_species, refine_E_threshold, "
+                "refine_E_gradient_threshold or refine_function(x,y,z,t)");
+            pp.query("refine_hysteresis", refine_hysteresis);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(refine_hysteresis > 0. && refine_hysteresis <= 1.,
+                "warpx.refine_hysteresis must be in (0, 1]");
         }
 
         pp.query("load_balance_int", load_balance_int);
         pp.query("load_balance_with_sfc", load_balance_with_sfc);
         pp.query("load_balance_knapsack_factor", load_balance_knapsack_factor);
+        pp.query("load_balance_efficiency_ratio_threshold", load_balance_efficiency_ratio_threshold);
 
         pp.query("do_dynamic_scheduling", do_dynamic_scheduling);
 
+        pp.query("fused_particle_kernel", fused_particle_kernel);
+#ifdef WARPX_NO_PARTICLE_FIELDS
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(fused_particle_kernel,
+            "warpx.fused_particle_kernel=0 requires the particle field attributes, "
+            "which are not available with USE_PARTICLE_FIELDS=FALSE");
+#endif
+
         pp.query("do_nodal", do_nodal);
         if (do_nodal) {
             Bx_nodal_flag = IntVect::TheNodeVector();
@@ -707,6 +785,16 @@ WarpX::ReadParameters ()
     {
         ParmParse pp("algo");
         current_deposition_algo = GetAlgorithmInteger(pp, "current_deposition");
+#if (defined AMREX_USE_GPU) || (defined WARPX_DIM_RZ)
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            current_deposition_algo != CurrentDepositionAlgo::Vectorized,
+            "algo.current_deposition=vectorized is only implemented on CPU, in 2D (XZ) and 3D");
+#endif
+#ifdef WARPX_NO_PARTICLE_FIELDS
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            current_deposition_algo != CurrentDepositionAlgo::Vectorized,
+            "algo.current_deposition=vectorized requires compiling with USE_PARTICLE_FIELDS=TRUE");
+#endif
         charge_deposition_algo = GetAlgorithmInteger(pp, "charge_deposition");
         particle_pusher_algo = GetAlgorithmInteger(pp, "particle_pusher");
         maxwell_fdtd_solver_id = GetAlgorithmInteger(pp, "maxwell_fdtd_solver");
@@ -732,6 +820,10 @@ WarpX::ReadParameters ()
         pp.query("v_galilean", v_galilean);
       // Scale the velocity by the speed of light
         for (int i=0; i<3; i++) v_galilean[i] *= PhysConst::c;
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_hybrid_mpi_decomposition || load_balance_int <= 0,
+            "Load balancing is not supported with psatd.hybrid_mpi_decomposition");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!fft_hybrid_mpi_decomposition || regrid_int <= 0,
+            "Regridding is not supported with psatd.hybrid_mpi_decomposition");
     }
 #endif
 
@@ -791,6 +883,8 @@ void
 WarpX::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& new_grids,
                                 const DistributionMapping& new_dmap)
 {
+    m_poisson_solver.reset();
+
     AllocLevelData(lev, new_grids, new_dmap);
     InitLevelData(lev, time);
 
@@ -809,6 +903,11 @@ WarpX::MakeNewLevelFromScratch (int lev, Real time, const BoxArray& new_grids,
 void
 WarpX::ClearLevel (int lev)
 {
+    // The scratch fields are defined on the grids of the levels
+    scratch_pool->Clear();
+    // So are the operator and multigrid hierarchy of the Poisson solver
+    m_poisson_solver.reset();
+
     for (int i = 0; i < 3; ++i) {
         Efield_aux[lev][i].reset();
         Bfield_aux[lev][i].reset();
@@ -838,6 +937,8 @@ WarpX::ClearLevel (int lev)
     F_cp  [lev].reset();
     rho_cp[lev].reset();
 
+    pml[lev].reset();
+
     if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers) {
         costs[lev].reset();
     } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic) {
@@ -1121,7 +1222,7 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
 
     if (load_balance_int > 0) {
         if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers) {
-            costs[lev].reset(new MultiFab(ba, dm, 1, 0));
+            costs[lev].reset(new CostLedger(ba.size(), dm));
         } else if (WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Heuristic) {
             costs_heuristic[lev].reset(new amrex::Vector<Real>);
             const int nboxes = Efield_fp[lev][0].get()->size();
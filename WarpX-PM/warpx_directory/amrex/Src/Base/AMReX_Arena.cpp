@@ -4,6 +4,7 @@
 #include <AMReX_CArena.H>
 #include <AMReX_DArena.H>
 #include <AMReX_EArena.H>
+#include <AMReX_PArena.H>
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -23,11 +24,17 @@ namespace {
     Arena* the_managed_arena = nullptr;
     Arena* the_pinned_arena = nullptr;
     Arena* the_cpu_arena = nullptr;
+    Arena* the_particle_arena = nullptr;
+    PArena* the_pmem_arena = nullptr;
 
     bool use_buddy_allocator = false;
     long buddy_allocator_size = 0L;
     long the_arena_init_size = 0L;
     bool abort_on_out_of_gpu_memory = false;
+    std::string the_arena_type = "default";
+    std::string particle_arena_type = "default";
+    std::string pmem_dir = ".";
+    long pmem_hunk_size = 0L;
 }
 
 const std::size_t Arena::align_size;
@@ -145,13 +152,37 @@ Arena::Initialize ()
     BL_ASSERT(the_managed_arena == nullptr);
     BL_ASSERT(the_pinned_arena == nullptr);
     BL_ASSERT(the_cpu_arena == nullptr);
+    BL_ASSERT(the_particle_arena == nullptr);
+    BL_ASSERT(the_pmem_arena == nullptr);
 
     ParmParse pp("amrex");
     pp.query("use_buddy_allocator", use_buddy_allocator);
     pp.query("buddy_allocator_size", buddy_allocator_size);
     pp.query("the_arena_init_size", the_arena_init_size);
     pp.query("abort_on_out_of_gpu_memory", abort_on_out_of_gpu_memory);
+    pp.query("the_arena", the_arena_type);
+    pp.query("particle_arena", particle_arena_type);
+    pp.query("pmem_dir", pmem_dir);
+    pp.query("pmem_hunk_size", pmem_hunk_size);
+
+    for (const auto& t : {the_arena_type, particle_arena_type}) {
+        if (t != "default" && t != "pmem") {
+            amrex::Abort("Arena::Initialize: unknown arena type " + t
+                         + ", amrex.the_arena and amrex.particle_arena must be default or pmem");
+        }
+    }
+    if (the_arena_type == "pmem" || particle_arena_type == "pmem") {
+#ifdef AMREX_USE_GPU
+        amrex::Abort("Arena::Initialize: the pmem arena is only accessible from the host");
+#endif
+        the_pmem_arena = new PArena(pmem_dir, static_cast<std::size_t>(pmem_hunk_size));
+    }
 
+    if (the_arena_type == "pmem")
+    {
+        the_arena = the_pmem_arena;
+    }
+    else
 #ifdef AMREX_USE_GPU
     if (use_buddy_allocator)
     {
@@ -213,6 +244,17 @@ Arena::Initialize ()
     the_pinned_arena->free(p);
 
     the_cpu_arena = new BArena;
+
+    // The particle data is in the same memory as the fabs by default
+    if (particle_arena_type == "pmem") {
+        the_particle_arena = the_pmem_arena;
+    } else {
+#ifdef AMREX_USE_GPU
+        the_particle_arena = the_arena;
+#else
+        the_particle_arena = the_cpu_arena;
+#endif
+    }
 }
 
 void
@@ -269,6 +311,12 @@ Arena::PrintUsage ()
             p->PrintUsage("The  Pinned Arena");
         }
     }
+    if (The_Particle_Arena() && The_Particle_Arena() != The_Arena()) {
+        CArena* p = dynamic_cast<CArena*>(The_Particle_Arena());
+        if (p) {
+            p->PrintUsage("The Particle Arena");
+        }
+    }
 }
     
 void
@@ -280,8 +328,13 @@ Arena::Finalize ()
     
     initialized = false;
     
-    delete the_arena;
+    if (the_arena != the_pmem_arena) delete the_arena;
     the_arena = nullptr;
+
+    the_particle_arena = nullptr;
+
+    delete the_pmem_arena;
+    the_pmem_arena = nullptr;
     
     delete the_device_arena;
     the_device_arena = nullptr;
@@ -331,4 +384,11 @@ The_Cpu_Arena ()
     return the_cpu_arena;
 }
 
+Arena*
+The_Particle_Arena ()
+{
+    BL_ASSERT(the_particle_arena != nullptr);
+    return the_particle_arena;
+}
+
 }
@@ -25,6 +25,8 @@ NFilesIter::NFilesIter(int noutfiles, const std::string &fileprefix,
   filePrefix    = fileprefix;
   fullFileName  = FileName(fileNumber, filePrefix);
   useSparseFPP  = false;
+  isStaged      = false;
+  stagedBase    = 0;
 
   finishedWriting = false;
 
@@ -72,6 +74,11 @@ NFilesIter::NFilesIter(int noutfiles, const std::string &fileprefix,
 
 void NFilesIter::SetDynamic(int deciderproc)
 {
+  // ---- staged data is written in the static set order, because the
+  // ---- offsets in the files are passed from one set to the next
+  if(NFilesStage::Active() != nullptr) {
+    return;
+  }
   deciderProc = deciderproc;
   // ---- we have to check currentDeciderIndex here also in case of
   // ---- different nfiles for plots and checkpoints
@@ -205,6 +212,10 @@ NFilesIter::~NFilesIter() {
 
 bool NFilesIter::ReadyToWrite(bool appendFirst) {
 
+  if(appendFirst && NFilesStage::Active() != nullptr) {
+    amrex::Abort("NFilesIter::ReadyToWrite:  appendFirst cannot be used with NFilesStage");
+  }
+
 #ifdef BL_USE_MPI
 
   if(finishedWriting) {
@@ -217,14 +228,9 @@ bool NFilesIter::ReadyToWrite(bool appendFirst) {
 
       if(mySparseFileNumber != -1) {
         if( ! appendFirst) {
-          fileStream.open(fullFileName.c_str(),
-                          std::ios::out | std::ios::trunc | std::ios::binary);
+          OpenWrite(std::ios::out | std::ios::trunc | std::ios::binary, 0);
         } else {
-          fileStream.open(fullFileName.c_str(),
-                          std::ios::out | std::ios::app | std::ios::binary);
-        }
-        if( ! fileStream.good()) {
-          amrex::FileOpenFailed(fullFileName);
+          OpenWrite(std::ios::out | std::ios::app | std::ios::binary, 0);
         }
         return true;
       } else {
@@ -237,26 +243,22 @@ bool NFilesIter::ReadyToWrite(bool appendFirst) {
     for(int iSet(0); iSet < nSets; ++iSet) {
       if(mySetPosition == iSet) {
         if(iSet == 0 && ! appendFirst) {   // ---- first set
-          fileStream.open(fullFileName.c_str(),
-                          std::ios::out | std::ios::trunc | std::ios::binary);
+          OpenWrite(std::ios::out | std::ios::trunc | std::ios::binary, 0);
         } else {
-          fileStream.open(fullFileName.c_str(),
-                          std::ios::out | std::ios::app | std::ios::binary);
-        }
-        if( ! fileStream.good()) {
-          amrex::FileOpenFailed(fullFileName);
+          OpenWrite(std::ios::out | std::ios::app | std::ios::binary, stagedBase);
         }
         return true;
       }
 
       if(mySetPosition == (iSet + 1)) {   // ---- next set waits
-        int iBuff, waitForPID(-1);
+        // ---- the message is the end of the file written by the previous set
+        int waitForPID(-1);
         if(groupSets) {
           waitForPID = (myProc - nOutFiles);
         } else {
           waitForPID = (myProc - 1);
         }
-        ParallelDescriptor::Recv(&iBuff, 1, waitForPID, stWriteTag);
+        ParallelDescriptor::Recv(&stagedBase, 1, waitForPID, stWriteTag);
       }
     }
     }
@@ -313,16 +315,41 @@ bool NFilesIter::ReadyToWrite(bool appendFirst) {
   if(finishedWriting) {
     return false;
   }
-  fileStream.open(fullFileName.c_str(),
-                  std::ios::out | std::ios::trunc | std::ios::binary);
-  if( ! fileStream.good()) {
-    amrex::FileOpenFailed(fullFileName);
-  }
+  OpenWrite(std::ios::out | std::ios::trunc | std::ios::binary, 0);
   return true;
 #endif
 }
 
 
+void NFilesIter::OpenWrite(std::ios::openmode mode, long offset) {
+  NFilesStage *stage = NFilesStage::Active();
+  isStaged = (stage != nullptr);
+  if(isStaged) {
+    // ---- the stream writes to the stage instead of the file
+    fileStream.std::basic_ios<char>::rdbuf(stage->Open(fullFileName, offset));
+  } else {
+    fileStream.open(fullFileName.c_str(), mode);
+    if( ! fileStream.good()) {
+      amrex::FileOpenFailed(fullFileName);
+    }
+  }
+}
+
+
+long NFilesIter::CloseWrite() {
+  fileStream.flush();
+  long fileEnd(0);
+  if(isStaged) {
+    fileEnd = fileStream.tellp();
+    fileStream.std::basic_ios<char>::rdbuf(fileStream.rdbuf());
+    isStaged = false;
+  } else {
+    fileStream.close();
+  }
+  return fileEnd;
+}
+
+
 bool NFilesIter::ReadyToRead() {
 
   if(finishedReading) {
@@ -365,17 +392,15 @@ NFilesIter &NFilesIter::operator++() {
       if(useSparseFPP) {
 
         if(mySparseFileNumber != -1) {
-          fileStream.flush();
-          fileStream.close();
+          CloseWrite();
 	}
         finishedWriting = true;
 
       } else {  // ---- the general static set selection
 
-      fileStream.flush();
-      fileStream.close();
+      long fileEnd(CloseWrite());
 
-      int iBuff(0), wakeUpPID(-1);
+      int wakeUpPID(-1);
       if(groupSets) {
         wakeUpPID = (myProc + nOutFiles);
       } else {
@@ -384,7 +409,7 @@ NFilesIter &NFilesIter::operator++() {
       if(wakeUpPID < nProcs) {
         int nextSP = WhichSetPosition(wakeUpPID, nProcs, nOutFiles, groupSets);
         if(nextSP > mySetPosition) {
-          ParallelDescriptor::Send(&iBuff, 1, wakeUpPID, stWriteTag);
+          ParallelDescriptor::Send(&fileEnd, 1, wakeUpPID, stWriteTag);
         }
       }
       finishedWriting = true;
@@ -483,8 +508,7 @@ NFilesIter &NFilesIter::operator++() {
     fileStream.close();
     finishedReading = true;
   } else {  // ---- writing
-    fileStream.flush();
-    fileStream.close();
+    CloseWrite();
     finishedWriting = true;
   }
 #endif
@@ -0,0 +1,186 @@
+
+#include <AMReX_NFilesStage.H>
+#include <AMReX_Arena.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace amrex {
+
+NFilesStage* NFilesStage::active = nullptr;
+
+//
+// The data written to one file by this process, in pinned memory that
+// grows as needed and is kept when the segment is reused.
+//
+class NFilesStage::Segment
+    : public std::streambuf
+{
+public:
+
+    ~Segment () { if (m_data) The_Pinned_Arena()->free(m_data); }
+
+    void Reset (const std::string& name, long offset)
+    {
+        m_name = name;
+        m_offset = offset;
+        m_size = 0;
+    }
+
+    const std::string& Name () const { return m_name; }
+    long Offset () const { return m_offset; }
+    long Size () const { return m_size; }
+    const char* Data () const { return m_data; }
+
+protected:
+
+    virtual std::streamsize xsputn (const char* s, std::streamsize n) override
+    {
+        Reserve(m_size + n);
+        std::memcpy(m_data + m_size, s, n);
+        m_size += n;
+        return n;
+    }
+
+    virtual int_type overflow (int_type c) override
+    {
+        if (c != traits_type::eof()) {
+            const char ch = traits_type::to_char_type(c);
+            xsputn(&ch, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    virtual pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                              std::ios_base::openmode which) override
+    {
+        // Only tellp and seekp to the end, which is the current position, are supported
+        if (off != 0 || dir == std::ios_base::beg || ! (which & std::ios_base::out)) {
+            return pos_type(off_type(-1));
+        }
+        return pos_type(m_offset + m_size);
+    }
+
+private:
+
+    void Reserve (long n)
+    {
+        if (n <= m_capacity) return;
+        const long capacity = std::max(n, 2*m_capacity);
+        char* data = static_cast<char*>(The_Pinned_Arena()->alloc(capacity));
+        if (m_size > 0) std::memcpy(data, m_data, m_size);
+        if (m_data) The_Pinned_Arena()->free(m_data);
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+    std::string m_name;
+    long m_offset = 0;
+    long m_size = 0;
+    long m_capacity = 0;
+    char* m_data = nullptr;
+};
+
+NFilesStage::NFilesStage ()
+    : m_failed(false)
+{}
+
+NFilesStage::~NFilesStage ()
+{
+    if (active == this) active = nullptr;
+    for (auto& t : m_threads) t.join();
+}
+
+std::streambuf*
+NFilesStage::Open (const std::string& name, long offset)
+{
+    if (m_nused == static_cast<int>(m_segments.size())) {
+        m_segments.emplace_back(new Segment);
+    }
+    Segment* seg = m_segments[m_nused++].get();
+    seg->Reset(name, offset);
+    if (offset == 0) {
+        // The first writer truncates the file now, before any process of
+        // its set can launch the writes of its data.
+        const int fd = ::open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) amrex::FileOpenFailed(name);
+        ::close(fd);
+    }
+    return seg;
+}
+
+void
+NFilesStage::Unlink (const std::string& name)
+{
+    m_unlink.push_back(name);
+}
+
+void
+NFilesStage::Launch (int nthreads)
+{
+    BL_PROFILE("NFilesStage::Launch()");
+    nthreads = std::max(1, std::min(nthreads, m_nused));
+    m_failed = false;
+    for (int ithread = 0; ithread < nthreads; ++ithread)
+    {
+        m_threads.emplace_back([this, ithread, nthreads] ()
+        {
+            for (int i = ithread; i < m_nused; i += nthreads)
+            {
+                const Segment& seg = *m_segments[i];
+                if (seg.Size() == 0) continue;
+                // The file is not truncated: the other processes of the
+                // set write to other parts of it.
+                const int fd = ::open(seg.Name().c_str(), O_WRONLY | O_CREAT, 0666);
+                bool ok = (fd >= 0);
+                long pos = 0;
+                while (ok && pos < seg.Size()) {
+                    const ssize_t n = ::pwrite(fd, seg.Data() + pos, seg.Size() - pos,
+                                               seg.Offset() + pos);
+                    ok = (n > 0);
+                    if (ok) pos += n;
+                }
+                if (fd >= 0 && ::close(fd) != 0) ok = false;
+                if ( ! ok && ! m_failed.exchange(true)) {
+                    m_failed_file = seg.Name();
+                }
+            }
+        });
+    }
+}
+
+void
+NFilesStage::Finish ()
+{
+    BL_PROFILE("NFilesStage::Finish()");
+    for (auto& t : m_threads) t.join();
+    m_threads.clear();
+    if (m_failed) {
+        amrex::Abort("NFilesStage::Finish: unable to write " + m_failed_file);
+    }
+
+    ParallelDescriptor::Barrier();
+
+    for (const auto& name : m_unlink) {
+        amrex::UnlinkFile(name);
+    }
+    m_unlink.clear();
+    m_nused = 0;
+}
+
+long
+NFilesStage::NBytes () const
+{
+    long nbytes = 0;
+    for (int i = 0; i < m_nused; ++i) {
+        nbytes += m_segments[i]->Size();
+    }
+    return nbytes;
+}
+
+}
@@ -0,0 +1,68 @@
+
+#include <AMReX_PArena.H>
+#include <AMReX.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace amrex {
+
+PArena::PArena (const std::string& dir, std::size_t hunk_size)
+    :
+    CArena(hunk_size == 0 ? std::size_t(DefaultHunkSize) : hunk_size),
+    m_dir(dir)
+{
+    if ( ! amrex::UtilCreateDirectory(m_dir, 0755)) {
+        amrex::CreateDirectoryFailed(m_dir);
+    }
+}
+
+PArena::~PArena ()
+{
+    //
+    // ~CArena cannot call our deallocate_system.
+    //
+    for (unsigned int i = 0, N = m_alloc.size(); i < N; i++) {
+        deallocate_system(m_alloc[i].first, m_alloc[i].second);
+    }
+    m_alloc.clear();
+}
+
+void*
+PArena::allocate_system (std::size_t nbytes)
+{
+    const std::string name = m_dir + "/amrex_pmem_" + std::to_string(ParallelDescriptor::MyProc())
+        + "_" + std::to_string(::getpid()) + "_" + std::to_string(m_nfiles++);
+
+    const int fd = ::open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        amrex::FileOpenFailed(name);
+    }
+    if (::ftruncate(fd, nbytes) != 0) {
+        amrex::Abort("PArena: unable to resize " + name + ": " + std::strerror(errno));
+    }
+    void* p = ::mmap(nullptr, nbytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        amrex::Abort("PArena: unable to map " + name + ": " + std::strerror(errno));
+    }
+    //
+    // The mapping keeps the file alive until it is unmapped.
+    //
+    ::close(fd);
+    ::unlink(name.c_str());
+    return p;
+}
+
+void
+PArena::deallocate_system (void* p, std::size_t nbytes)
+{
+    ::munmap(p, nbytes);
+}
+
+}